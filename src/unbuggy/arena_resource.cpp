@@ -0,0 +1,51 @@
+/// @file arena_resource.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include "unbuggy/arena_resource.hpp"
+
+namespace unbuggy {
+
+// The base forwards allocations to m_arena, which is declared after the base
+// and so is constructed after it.  The base only stores the pointer until
+// the first allocation.
+
+arena_resource::arena_resource( std::pmr::memory_resource* upstream )
+  : info_resource( &m_arena )
+  , m_arena( upstream )
+{ }
+
+arena_resource::arena_resource(
+        std::size_t                initial_size
+      , std::pmr::memory_resource* upstream)
+  : info_resource( &m_arena )
+  , m_arena( initial_size, upstream )
+{ }
+
+arena_resource::arena_resource(
+        void*                      buffer
+      , std::size_t                size
+      , std::pmr::memory_resource* upstream)
+  : info_resource( &m_arena )
+  , m_arena( buffer, size, upstream )
+{ }
+
+arena_resource::~arena_resource()
+{ }
+
+std::pmr::memory_resource* arena_resource::upstream_resource() const
+{
+    return m_arena.upstream_resource();
+}
+
+void arena_resource::release()
+{
+    m_arena.release();
+}
+
+void arena_resource::do_deallocate(void*, std::size_t bytes, std::size_t)
+{
+    record_deallocate(bytes);
+}
+
+}  /// \namespace unbuggy
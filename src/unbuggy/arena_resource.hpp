@@ -0,0 +1,82 @@
+/// \file arena_resource.hpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#ifndef INCLUDED_UNBUGGY_ARENA_RESOURCE
+#define INCLUDED_UNBUGGY_ARENA_RESOURCE
+
+#include "unbuggy/info_resource.hpp"
+
+#include <cstddef>          // size_t
+#include <memory_resource>  // monotonic_buffer_resource
+
+namespace unbuggy {
+
+/// A memory resource that hands out blocks consecutively from a growing
+/// arena, counting them as an \c info_resource does.  The arena starts with
+/// an optional buffer supplied by the user, then takes chunks of growing size
+/// from an upstream resource.  Deallocation is counted, but never reaches the
+/// arena, which reclaims nothing until it is released or destroyed; an arena
+/// suits many short-lived objects that die together.
+///
+/// An \c arena_resource serves one thread at a time: calls to \c allocate,
+/// \c deallocate, and \c release must not overlap.  Its statistics may be
+/// read from any thread.
+///
+class arena_resource: public info_resource {
+
+    std::pmr::monotonic_buffer_resource m_arena;    ///< underlying arena
+
+  public:
+
+    explicit arena_resource(
+            std::pmr::memory_resource* upstream =
+                std::pmr::get_default_resource());
+        ///< Creates an empty arena acquiring memory from \a upstream, which
+        /// must outlive this object.
+
+    arena_resource(
+            std::size_t                initial_size
+          , std::pmr::memory_resource* upstream =
+                std::pmr::get_default_resource());
+        ///< Creates an empty arena acquiring memory from \a upstream, which
+        /// must outlive this object, starting with a chunk of at least \a
+        /// initial_size bytes.
+
+    arena_resource(
+            void*                      buffer
+          , std::size_t                size
+          , std::pmr::memory_resource* upstream =
+                std::pmr::get_default_resource());
+        ///< Creates an arena allocating first from the \a size bytes at \a
+        /// buffer, then from \a upstream.  \a buffer and \a upstream must
+        /// outlive this object.
+
+    ~arena_resource();
+        ///< Destroys this object, returning all memory to the upstream
+        /// resource.
+
+    std::pmr::memory_resource* upstream_resource() const override;
+        ///< Returns the resource from which the arena takes chunks once the
+        /// initial buffer, if any, is exhausted.
+
+    void release();
+        ///< Returns all memory to the upstream resource.  Subsequent
+        /// allocations begin again from the initial buffer, if any.  Does not
+        /// change the statistics: blocks not yet deallocated remain live
+        /// until they are, as when a container outlives the release.
+
+  protected:
+
+    void do_deallocate(
+            void*       p
+          , std::size_t bytes
+          , std::size_t alignment) override;
+        ///< Counts the deallocation of the block of \a bytes at \a p, which
+        /// must have been returned by a previous call to \c allocate, and not
+        /// yet deallocated.  Reclaims nothing.
+};
+
+}  /// \namespace unbuggy
+
+#endif
@@ -0,0 +1,101 @@
+/// @file arena_resource_test.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+#include "unbuggy/arena_resource.hpp"
+
+#include <cassert>          // assert
+#include <vector>           // pmr::vector
+
+using unbuggy::arena_resource;
+using unbuggy::info_resource;
+
+void test_buffer()
+{
+    // Allocations are served from the initial buffer while it lasts.
+
+    alignas(16) char buffer[1024];
+    info_resource    upstream;
+    arena_resource   arena( buffer, sizeof buffer, &upstream );
+    assert(arena.upstream_resource() == &upstream);
+
+    info_resource& base = arena;        // does not expose the std arena
+    assert(base.upstream_resource() == &upstream);
+
+    void* p = arena.allocate(100, 1);
+    assert(p == buffer);
+    assert(arena.memory_now()    == 100);
+    assert(upstream.memory_now() == 0);
+
+    // Deallocation is counted, but reclaims nothing.
+
+    arena.deallocate(p, 100, 1);
+    assert(arena.memory_now()       == 0);
+    assert(arena.deallocate_calls() == 1);
+
+    void* q = arena.allocate(100, 1);
+    assert(q != p);
+
+    // Allocations beyond the buffer go upstream.
+
+    (void)arena.allocate(2000);
+    assert(upstream.memory_now() >= 2000);
+
+    // Release returns all memory, and restarts from the buffer, but blocks
+    // not yet deallocated remain live.
+
+    arena.release();
+    assert(arena.objects_now()   == 2);
+    assert(arena.memory_now()    == 2100);
+    assert(upstream.memory_now() == 0);
+
+    void* r = arena.allocate(100, 1);
+    assert(r == buffer);
+}
+
+void test_containers()
+{
+    info_resource  upstream;
+    arena_resource arena( 4096, &upstream );
+
+    {
+        std::pmr::vector<int> v( &arena );
+        for (int i = 0; i < 100; ++i)
+            v.push_back(i);
+        assert(arena.objects_now() == 1);
+        assert(arena.memory_all()  >= 100 * sizeof(int));
+    }
+    assert(arena.objects_now() == 0);
+    assert(upstream.memory_now() >= 4096);
+
+    // A container may outlive a release, with its deallocation counted,
+    // even after newer blocks are allocated.
+
+    std::size_t calls = arena.deallocate_calls();
+    void*       p;
+    {
+        std::pmr::vector<int> v( 100, 0, &arena );
+        assert(arena.objects_now() == 1);
+
+        arena.release();
+        assert(arena.objects_now() == 1);
+
+        p = arena.allocate(50);
+        assert(arena.objects_now() == 2);
+    }
+    assert(arena.objects_now()      == 1);
+    assert(arena.memory_now()       == 50);
+    assert(arena.deallocate_calls() == calls + 1);
+
+    arena.deallocate(p, 50);
+    assert(arena.objects_now() == 0);
+    assert(arena.memory_now()  == 0);
+}
+
+int main()
+{
+    test_buffer();
+    test_containers();
+}
@@ -5,12 +5,32 @@
 #ifndef INCLUDED_UNBUGGY_INFO_ALLOCATOR
 #define INCLUDED_UNBUGGY_INFO_ALLOCATOR
 
-#include <memory>   // allocator, allocator_traits
+#include "unbuggy/latency_histogram.hpp"
 
-/// \cond DETAILS
+#include <memory>   // allocator, allocator_traits
 
 namespace unbuggy {
 
+/// A consistent copy of the statistics of an \c info_allocator copy group,
+/// as returned by \c info_allocator::snapshot.  Each member holds the value
+/// of the like-named accessor of \c info_allocator at a single instant.
+///
+/// \param Size_type the size type of the allocator
+///
+template <typename Size_type>
+struct info_snapshot {
+    Size_type allocate_calls;         ///< number of calls to \c allocate
+    Size_type deallocate_calls;       ///< number of calls to \c deallocate
+    Size_type objects_all;            ///< total number of objects allocated
+    Size_type objects_max;            ///< most simultaneous live objects seen
+    Size_type objects_now;            ///< number of currently live objects
+    Size_type memory_all;             ///< total amount of memory allocated
+    Size_type memory_max;             ///< highest amount of live memory yet
+    Size_type memory_now;             ///< amount of currently live memory
+};
+
+/// \cond DETAILS
+
 namespace info_allocator_details {
 
 template <typename Size_type>
@@ -35,6 +55,11 @@ struct shared_state;
 /// - amount of memory currently allocated (but not yet deallocated)
 /// - maximum amount of allocated memory live at any time
 ///
+/// Optionally, \c info_allocator also times a sample of the calls it forwards
+/// to the underlying allocator, recording latency histograms for allocation
+/// and deallocation (see \c time_calls).  Timing is off by default, and costs
+/// one test of a null pointer per call while off.
+///
 /// Statistics are shared by all copies of an \c info_allocator object
 /// (including rebound conversions).  For example, if <code>info_allocator
 /// b</code> is a copy of <code>info_allocator a</code>, all allocations from
@@ -43,6 +68,19 @@ struct shared_state;
 /// destroyed (or assigned a new value); the first instance need not be kept
 /// alive simply to maintain statistics.
 ///
+/// Statistics may be read from any thread while allocators in the copy group
+/// are in use, without blocking them.  Individual accessors return values
+/// that may be mutually inconsistent; \c snapshot returns all statistics as of
+/// a single instant.  Maxima are measured from construction, or from the most
+/// recent call to \c reset_peaks or \c snapshot_and_reset_peaks, so that a
+/// monitor can observe the peak within each of a series of intervals (see \c
+/// info_window).
+///
+/// Supporting consistent snapshots costs each allocation and deallocation
+/// two extra stores to a sequence number, whether or not statistics are
+/// read.  On weakly ordered processors, such as ARM, each of these stores
+/// also costs a memory barrier.
+///
 /// Memory consumption is measured as the sum of the sizes of all allocated
 /// objects.  Statistics do not include allocations for internal use by \c
 /// info_allocator or the underlying allocator.  Internal memory use of an \c
@@ -110,8 +148,17 @@ class info_allocator: A {
         /// result has reference count 1 and all other counts set to 0.
 
     void destroy_shared_state(shared_state* s) const;
-        ///< Destroys and deallocates \a s.  \a s is deallocated by this
-        /// object's underlying allocator.
+        ///< Destroys and deallocates \a s, and any latency monitor it holds.
+        /// \a s is deallocated by this object's underlying allocator.
+
+    latency_monitor* create_monitor(latency_options const& options) const;
+        ///< Creates and returns a \c latency_monitor configured by \a
+        /// options.  The monitor is allocated from a rebind of this object's
+        /// underlying allocator.
+
+    void destroy_monitor(latency_monitor* m) const;
+        ///< Destroys and deallocates \a m, unless \a m is null.  \a m is
+        /// deallocated by this object's underlying allocator.
 
   public:
 
@@ -211,6 +258,54 @@ class info_allocator: A {
 
     size_type memory_now() const;
         ///< Returns the amount of currently live memory.
+
+    info_snapshot<size_type> snapshot() const;
+        ///< Returns the statistics of this copy group as of a single instant.
+        /// May be called concurrently with allocation and deallocation by
+        /// other allocators in the copy group, which it never blocks; the
+        /// copy is retried if a write or a reset of peaks intervenes.
+
+    void reset_peaks();
+        ///< Lowers \c objects_max and \c memory_max to the current values of
+        /// \c objects_now and \c memory_now, starting a new interval over
+        /// which peaks are measured.  May be called concurrently with
+        /// allocation and deallocation by other allocators in the copy group,
+        /// and with other resets; no snapshot sees one peak reset without
+        /// the other.
+
+    info_snapshot<size_type> snapshot_and_reset_peaks();
+        ///< Returns the statistics of this copy group as of a single instant,
+        /// and resets peaks as by \c reset_peaks, as one operation.  The
+        /// returned peaks are those in effect at the reset, so that no peak
+        /// is lost between successive calls.  May be called concurrently as
+        /// \c reset_peaks.
+
+    void time_calls(latency_options const& options =latency_options( ));
+        ///< Starts timing a sample of the calls made by this copy group to
+        /// the underlying allocator, as configured by \a options.  Any
+        /// latencies previously recorded are discarded.  Timing state is
+        /// allocated from a rebind of the underlying allocator.  The behavior
+        /// is undefined if this function is called concurrently with any
+        /// other function of an allocator in this copy group.
+
+    void stop_timing();
+        ///< Stops timing calls to the underlying allocator, and discards all
+        /// recorded latencies.  Has no effect if calls are not being timed.
+        /// The behavior is undefined if this function is called concurrently
+        /// with any other function of an allocator in this copy group.
+
+    bool is_timing() const;
+        ///< Returns \c true if this copy group is timing calls.
+
+    latency_histogram allocate_latency() const;
+        ///< Returns the latencies, in ticks of \c cycle_count, of the timed
+        /// calls to \c allocate of the underlying allocator.  Returns an
+        /// empty histogram if calls are not being timed.
+
+    latency_histogram deallocate_latency() const;
+        ///< Returns the latencies, in ticks of \c cycle_count, of the timed
+        /// calls to \c deallocate of the underlying allocator.  Returns an
+        /// empty histogram if calls are not being timed.
 };
 
 template <typename T, typename A>
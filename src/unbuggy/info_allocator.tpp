@@ -2,8 +2,12 @@
 ///
 /// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
 
-#include <cassert>  // assert
-#include <utility>  // move
+#include <atomic>       // atomic, atomic_thread_fence
+#include <cassert>      // assert
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <type_traits>  // integral_constant, is_void
+#include <utility>      // move
 
 namespace unbuggy {
 
@@ -11,21 +15,322 @@ namespace unbuggy {
 
 namespace info_allocator_details {
 
-// Statistics shared by allocators in a copy group.
+// Statistics shared by allocators in a copy group.  Counters are written by
+// one allocator at a time, and may be read concurrently by any thread.  Each
+// write is bracketed by increments of a sequence number, which is odd while
+// the write is in progress, so that readers can detect and retry torn reads
+// without ever blocking writers.  Peak resets, which may come from any
+// thread, are likewise bracketed by increments of a second sequence number,
+// which also serializes them with one another.
 //
 template <typename Size_type>
 struct shared_state {
+    typedef std::atomic<Size_type> counter;
+
     Size_type ref_count;              // number of allocators sharing state
-    Size_type allocate_calls;         // number of calls to \c allocate
-    Size_type deallocate_calls;       // number of calls to \c deallocate
-    Size_type objects_all;            // total number of objects allocated
-    Size_type objects_max;            // most simultaneous live objects seen
-    Size_type objects_now;            // number of currently live objects
-    Size_type memory_all;             // total amount of memory allocated
-    Size_type memory_max;             // highest amount of live memory yet
-    Size_type memory_now;             // amount of currently live memory
+    counter sequence;                 // number of writes begun and ended
+    counter resets;                   // number of resets begun and ended
+    counter allocate_calls;           // number of calls to \c allocate
+    counter deallocate_calls;         // number of calls to \c deallocate
+    counter objects_all;              // total number of objects allocated
+    counter objects_max;              // most simultaneous live objects seen
+    counter objects_now;              // number of currently live objects
+    counter memory_all;               // total amount of memory allocated
+    counter memory_max;               // highest amount of live memory yet
+    counter memory_now;               // amount of currently live memory
+    latency_monitor* monitor;         // call timing, or null if not timed
 };
 
+// Returns the value of the specified counter, which may be written
+// concurrently.
+//
+template <typename Size_type>
+Size_type read(std::atomic<Size_type> const& c)
+{
+    return c.load(std::memory_order_relaxed);
+}
+
+// Adds the specified value to the specified counter.  Only the thread
+// writing the shared state may call this function, so the counter is updated
+// by a plain load and store rather than an atomic read-modify-write.
+//
+template <typename Size_type>
+void add(std::atomic<Size_type>& c, Size_type n)
+{
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Subtracts the specified value from the specified counter.  Only the thread
+// writing the shared state may call this function.
+//
+template <typename Size_type>
+void subtract(std::atomic<Size_type>& c, Size_type n)
+{
+    c.store(c.load(std::memory_order_relaxed) - n, std::memory_order_relaxed);
+}
+
+// Raises the specified maximum to at least the specified value.  Only the
+// thread writing the shared state may call this function.
+//
+template <typename Size_type>
+void raise(std::atomic<Size_type>& max, Size_type value)
+{
+    if (value > max.load(std::memory_order_relaxed))
+        max.store(value, std::memory_order_relaxed);
+}
+
+// Marks the start of a write to the specified state.
+//
+template <typename Size_type>
+void begin_write(shared_state<Size_type>& s)
+{
+    s.sequence.store(
+            s.sequence.load(std::memory_order_relaxed) + 1
+          , std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+// Marks the end of a write to the specified state.
+//
+template <typename Size_type>
+void end_write(shared_state<Size_type>& s)
+{
+    s.sequence.store(
+            s.sequence.load(std::memory_order_relaxed) + 1
+          , std::memory_order_release);
+}
+
+// Marks the start of a reset of the peaks of the specified state, waiting
+// for any reset already in progress to end.
+//
+template <typename Size_type>
+void begin_reset(shared_state<Size_type>& s)
+{
+    Size_type n;
+
+    do {
+        n = s.resets.load(std::memory_order_relaxed);
+    } while (n % 2 || !s.resets.compare_exchange_weak(
+                n
+              , n + 1
+              , std::memory_order_acquire
+              , std::memory_order_relaxed));
+
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+// Marks the end of a reset of the peaks of the specified state.
+//
+template <typename Size_type>
+void end_reset(shared_state<Size_type>& s)
+{
+    s.resets.store(
+            s.resets.load(std::memory_order_relaxed) + 1
+          , std::memory_order_release);
+}
+
+// Records the allocation of the specified number of objects, occupying the
+// specified number of bytes.
+//
+template <typename Size_type>
+void record_allocate(
+        shared_state<Size_type>& s
+      , Size_type                objects
+      , Size_type                bytes)
+{
+    begin_write(s);
+
+    add(s.allocate_calls, Size_type(1));
+    add(s.objects_all, objects);
+    add(s.objects_now, objects);
+    raise(s.objects_max, read(s.objects_now));
+
+    add(s.memory_all, bytes);
+    add(s.memory_now, bytes);
+    raise(s.memory_max, read(s.memory_now));
+
+    end_write(s);
+}
+
+// Records the deallocation of the specified number of objects, occupying the
+// specified number of bytes.
+//
+template <typename Size_type>
+void record_deallocate(
+        shared_state<Size_type>& s
+      , Size_type                objects
+      , Size_type                bytes)
+{
+    assert(read(s.memory_now)  >= bytes);
+    assert(read(s.objects_now) >= objects);
+
+    begin_write(s);
+
+    subtract(s.memory_now, bytes);
+    subtract(s.objects_now, objects);
+    add(s.deallocate_calls, Size_type(1));
+
+    end_write(s);
+}
+
+// Loads the specified result with the counters of the specified state,
+// which may be written concurrently.
+//
+template <typename Size_type>
+void copy(shared_state<Size_type> const& s, info_snapshot<Size_type>& r)
+{
+    r.allocate_calls   = read(s.allocate_calls);
+    r.deallocate_calls = read(s.deallocate_calls);
+    r.objects_all      = read(s.objects_all);
+    r.objects_max      = read(s.objects_max);
+    r.objects_now      = read(s.objects_now);
+    r.memory_all       = read(s.memory_all);
+    r.memory_max       = read(s.memory_max);
+    r.memory_now       = read(s.memory_now);
+}
+
+// Raises the peaks of the specified snapshot to at least the current values,
+// which they may briefly trail when a write races with a reset.
+//
+template <typename Size_type>
+void clamp_peaks(info_snapshot<Size_type>& r)
+{
+    if (r.objects_max < r.objects_now)
+        r.objects_max = r.objects_now;
+    if (r.memory_max < r.memory_now)
+        r.memory_max = r.memory_now;
+}
+
+// Returns a consistent copy of the counters of the specified state.  Retries
+// until neither a write nor a reset overlaps the copy.
+//
+template <typename Size_type>
+info_snapshot<Size_type> snapshot(shared_state<Size_type> const& s)
+{
+    info_snapshot<Size_type> r;
+    Size_type before;
+    Size_type after;
+    Size_type resets_before;
+    Size_type resets_after;
+
+    do {
+        before        = s.sequence.load(std::memory_order_acquire);
+        resets_before = s.resets.load(std::memory_order_acquire);
+
+        copy(s, r);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after         = s.sequence.load(std::memory_order_relaxed);
+        resets_after  = s.resets.load(std::memory_order_relaxed);
+    } while (before != after || before % 2
+          || resets_before != resets_after || resets_before % 2);
+
+    clamp_peaks(r);
+
+    return r;
+}
+
+// Lowers the peaks of the specified state to the current values.  May be
+// called concurrently with writes, and with other resets.  A write racing
+// with the reset may leave a peak below its current value, which the next
+// write or snapshot corrects.
+//
+template <typename Size_type>
+void reset_peaks(shared_state<Size_type>& s)
+{
+    begin_reset(s);
+
+    s.objects_max.store(read(s.objects_now), std::memory_order_relaxed);
+    s.memory_max.store(read(s.memory_now), std::memory_order_relaxed);
+
+    end_reset(s);
+}
+
+// Returns a consistent copy of the counters of the specified state, and
+// lowers its peaks to the current values, as a single reset.  The returned
+// peaks are those in effect when the reset took place, so that no peak falls
+// between two successive calls.
+//
+template <typename Size_type>
+info_snapshot<Size_type> snapshot_and_reset_peaks(shared_state<Size_type>& s)
+{
+    info_snapshot<Size_type> r;
+    Size_type before;
+    Size_type after;
+
+    begin_reset(s);
+
+    do {
+        before = s.sequence.load(std::memory_order_acquire);
+        copy(s, r);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after  = s.sequence.load(std::memory_order_relaxed);
+    } while (before != after || before % 2);
+
+    r.objects_max = s.objects_max.exchange(
+            read(s.objects_now)
+          , std::memory_order_relaxed);
+    r.memory_max  = s.memory_max.exchange(
+            read(s.memory_now)
+          , std::memory_order_relaxed);
+
+    end_reset(s);
+
+    clamp_peaks(r);
+
+    return r;
+}
+
+// Calls the specified function, recording its latency and the specified
+// number of bytes under the specified operation of the specified monitor, and
+// returns its result.  Overloaded on whether the result is void.
+//
+template <typename Function>
+auto timed(
+        latency_monitor&                    m
+      , latency_operation                   op
+      , std::size_t                         bytes
+      , Function&                           f
+      , std::integral_constant<bool, false>) -> decltype(f())
+{
+    std::uint64_t start = cycle_count();
+    auto r = f();
+    m.record(op, cycle_count() - start, bytes);
+    return r;
+}
+
+template <typename Function>
+void timed(
+        latency_monitor&                    m
+      , latency_operation                   op
+      , std::size_t                         bytes
+      , Function&                           f
+      , std::integral_constant<bool, true>)
+{
+    std::uint64_t start = cycle_count();
+    f();
+    m.record(op, cycle_count() - start, bytes);
+}
+
+// Calls the specified function, which forwards a request of the specified
+// operation and number of bytes, and returns its result.  Times the call if
+// the specified monitor is not null and samples the call numbered by the
+// specified counter.  A call that throws is not timed.
+//
+template <typename Size_type, typename Function>
+auto timed_call(
+        latency_monitor*                m
+      , std::atomic<Size_type> const&   calls
+      , latency_operation               op
+      , std::size_t                     bytes
+      , Function                        f) -> decltype(f())
+{
+    if (m && m->samples(read(calls)))
+        return timed(*m, op, bytes, f, std::is_void<decltype(f())>());
+
+    return f();
+}
+
 }  // namespace info_allocator_details
 
 /// \endcond
@@ -56,10 +361,42 @@ void info_allocator<T, A>::destroy_shared_state(shared_state* s) const
     typename a_traits_t::template rebind_alloc<shared_state>
         b( static_cast<A const&>(*this) );
 
+    destroy_monitor(s->monitor);
     b_traits_t::destroy(b, s);
     b_traits_t::deallocate(b, s, 1);
 }
 
+template <typename T, typename A>
+latency_monitor*
+info_allocator<T, A>::create_monitor(latency_options const& options) const
+{
+    typedef typename a_traits_t::template rebind_traits<latency_monitor>
+        b_traits_t;
+
+    typename a_traits_t::template rebind_alloc<latency_monitor>
+        b( static_cast<A const&>(*this) );
+
+    latency_monitor* r = b_traits_t::allocate(b, 1);
+    b_traits_t::construct(b, r, options);
+
+    return r;
+}
+
+template <typename T, typename A>
+void info_allocator<T, A>::destroy_monitor(latency_monitor* m) const
+{
+    typedef typename a_traits_t::template rebind_traits<latency_monitor>
+        b_traits_t;
+
+    typename a_traits_t::template rebind_alloc<latency_monitor>
+        b( static_cast<A const&>(*this) );
+
+    if (m) {
+        b_traits_t::destroy(b, m);
+        b_traits_t::deallocate(b, m, 1);
+    }
+}
+
 template <typename T, typename A>
 info_allocator<T, A>::info_allocator( )
   : A( )
@@ -142,20 +479,17 @@ template <typename T, typename A>
 typename info_allocator<T, A>::pointer
 info_allocator<T, A>::allocate(size_type n, const_void_pointer u)
 {
-    pointer r = A::allocate(n, u);  // may throw
-
-    ++m_shared->allocate_calls;
-    m_shared->objects_all += n;
-    m_shared->objects_now += n;
-
-    if (m_shared->objects_now > m_shared->objects_max)
-        m_shared->objects_max = m_shared->objects_now;
-
-    m_shared->memory_all += n * sizeof(T);
-    m_shared->memory_now += n * sizeof(T);
-
-    if (m_shared->memory_now > m_shared->memory_max)
-        m_shared->memory_max = m_shared->memory_now;
+    pointer r = info_allocator_details::timed_call(
+            m_shared->monitor
+          , m_shared->allocate_calls
+          , latency_operation::allocate
+          , n * sizeof(T)
+          , [&] { return A::allocate(n, u); });     // may throw
+
+    info_allocator_details::record_allocate(
+            *m_shared
+          , n
+          , size_type(n * sizeof(T)));
 
     return r;
 }
@@ -163,14 +497,17 @@ info_allocator<T, A>::allocate(size_type n, const_void_pointer u)
 template <typename T, typename A>
 void info_allocator<T, A>::deallocate(pointer p, size_type n)
 {
-    assert(m_shared->memory_now  >= n * sizeof(T));
-    assert(m_shared->objects_now >= n);
-
-    m_shared->memory_now  -= n * sizeof(T);
-    m_shared->objects_now -= n;
-    ++m_shared->deallocate_calls;
-
-    A::deallocate(p, n);   // must not throw
+    info_allocator_details::timed_call(
+            m_shared->monitor
+          , m_shared->deallocate_calls
+          , latency_operation::deallocate
+          , n * sizeof(T)
+          , [&] { A::deallocate(p, n); });          // must not throw
+
+    info_allocator_details::record_deallocate(
+            *m_shared
+          , n
+          , size_type(n * sizeof(T)));
 }
 
 template <typename T, typename A>
@@ -199,56 +536,113 @@ template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::allocate_calls() const
 {
-    return m_shared->allocate_calls;
+    return info_allocator_details::read(m_shared->allocate_calls);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::deallocate_calls() const
 {
-    return m_shared->deallocate_calls;
+    return info_allocator_details::read(m_shared->deallocate_calls);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::objects_all() const
 {
-    return m_shared->objects_all;
+    return info_allocator_details::read(m_shared->objects_all);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::objects_max() const
 {
-    return m_shared->objects_max;
+    return info_allocator_details::read(m_shared->objects_max);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::objects_now() const
 {
-    return m_shared->objects_now;
+    return info_allocator_details::read(m_shared->objects_now);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::memory_all() const
 {
-    return m_shared->memory_all;
+    return info_allocator_details::read(m_shared->memory_all);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::memory_max() const
 {
-    return m_shared->memory_max;
+    return info_allocator_details::read(m_shared->memory_max);
 }
 
 template <typename T, typename A>
 typename info_allocator<T, A>::size_type
 info_allocator<T, A>::memory_now() const
 {
-    return m_shared->memory_now;
+    return info_allocator_details::read(m_shared->memory_now);
+}
+
+template <typename T, typename A>
+info_snapshot<typename info_allocator<T, A>::size_type>
+info_allocator<T, A>::snapshot() const
+{
+    return info_allocator_details::snapshot(*m_shared);
+}
+
+template <typename T, typename A>
+void info_allocator<T, A>::reset_peaks()
+{
+    info_allocator_details::reset_peaks(*m_shared);
+}
+
+template <typename T, typename A>
+info_snapshot<typename info_allocator<T, A>::size_type>
+info_allocator<T, A>::snapshot_and_reset_peaks()
+{
+    return info_allocator_details::snapshot_and_reset_peaks(*m_shared);
+}
+
+template <typename T, typename A>
+void info_allocator<T, A>::time_calls(latency_options const& options)
+{
+    latency_monitor* m = create_monitor(options);   // may throw
+    destroy_monitor(m_shared->monitor);
+    m_shared->monitor = m;
+}
+
+template <typename T, typename A>
+void info_allocator<T, A>::stop_timing()
+{
+    destroy_monitor(m_shared->monitor);
+    m_shared->monitor = nullptr;
+}
+
+template <typename T, typename A>
+bool info_allocator<T, A>::is_timing() const
+{
+    return m_shared->monitor != nullptr;
+}
+
+template <typename T, typename A>
+latency_histogram info_allocator<T, A>::allocate_latency() const
+{
+    return m_shared->monitor
+         ? m_shared->monitor->histogram(latency_operation::allocate)
+         : latency_histogram( );
+}
+
+template <typename T, typename A>
+latency_histogram info_allocator<T, A>::deallocate_latency() const
+{
+    return m_shared->monitor
+         ? m_shared->monitor->histogram(latency_operation::deallocate)
+         : latency_histogram( );
 }
 
 }  /// \namespace unbuggy
@@ -8,7 +8,9 @@
 
 #include "unbuggy/info_allocator.hpp"
 
+#include <atomic>       // atomic
 #include <cassert>      // assert
+#include <thread>       // thread
 #include <type_traits>  // is_same, static_assert
 
 // The C++ Standard 14882-2012 specifies, in [allocator.requirements], a number
@@ -409,8 +411,167 @@ void test_further_requirements()
     mn =              0;                    assert(a.memory_now()       == mn);
 }
 
+void test_snapshot()
+{
+    // A snapshot matches the individual accessors.
+
+    X a;
+    XX::pointer p = XX::allocate(a, 3);
+    XX::pointer q = XX::allocate(a, 2);
+    XX::deallocate(a, p, 3);
+
+    unbuggy::info_snapshot<X::size_type> s = a.snapshot();
+    assert(s.allocate_calls   == a.allocate_calls());
+    assert(s.deallocate_calls == a.deallocate_calls());
+    assert(s.objects_all      == 5);
+    assert(s.objects_max      == 5);
+    assert(s.objects_now      == 2);
+    assert(s.memory_all       == 5 * sizeof(T));
+    assert(s.memory_max       == 5 * sizeof(T));
+    assert(s.memory_now       == 2 * sizeof(T));
+
+    // Resetting peaks lowers them to the current values, for the whole copy
+    // group, without affecting other statistics.
+
+    X b( a );
+    b.reset_peaks();
+    assert(a.objects_max() == 2);
+    assert(a.memory_max()  == 2 * sizeof(T));
+    assert(a.objects_all() == 5);
+
+    p = XX::allocate(a, 1);
+    assert(b.snapshot().objects_max == 3);
+
+    XX::deallocate(a, p, 1);
+    XX::deallocate(a, q, 2);
+    assert(b.snapshot().objects_max == 3);
+    b.reset_peaks();
+    assert(b.snapshot().objects_max == 0);
+
+    // A combined snapshot and reset returns the peaks it resets.
+
+    p = XX::allocate(a, 4);
+    XX::deallocate(a, p, 4);
+    s = b.snapshot_and_reset_peaks();
+    assert(s.objects_max   == 4);
+    assert(s.objects_now   == 0);
+    assert(s.memory_max    == 4 * sizeof(T));
+    assert(a.objects_max() == 0);
+    assert(a.memory_max()  == 0);
+}
+
+// Asserts that the specified snapshot, taken while a writer allocates and
+// immediately deallocates between 1 and 7 objects of type T, is consistent.
+//
+void check_consistent(unbuggy::info_snapshot<X::size_type> const& s)
+{
+    X::size_type live = s.allocate_calls - s.deallocate_calls;
+
+    assert(live == 0 || live == 1);
+    assert(live == 0 ? s.objects_now == 0
+                     : s.objects_now >= 1 && s.objects_now <= 7);
+    assert(s.memory_now  == s.objects_now * sizeof(T));
+    assert(s.memory_all  == s.objects_all * sizeof(T));
+    assert(s.objects_max >= s.objects_now && s.objects_max <= 7);
+    assert(s.memory_max  >= s.memory_now  && s.memory_max  <= 7 * sizeof(T));
+}
+
+void test_concurrent_snapshot()
+{
+    // Snapshots and resets taken from other threads while one thread
+    // allocates are always internally consistent, and never block it.
+
+    X a;
+    X b( a );                               // copied before threads start
+    std::atomic<bool> done( false );
+
+    std::thread writer([&] {
+        for (int i = 0; i < 200000; ++i) {
+            XX::size_type n = 1 + i % 7;
+            XX::deallocate(a, XX::allocate(a, n), n);
+        }
+        done = true;
+    });
+
+    std::thread resetter([&] {
+        while (!done) {
+            check_consistent(b.snapshot_and_reset_peaks());
+            b.reset_peaks();
+        }
+    });
+
+    while (!done)
+        check_consistent(b.snapshot());
+
+    writer.join();
+    resetter.join();
+
+    unbuggy::info_snapshot<X::size_type> s = b.snapshot();
+    check_consistent(s);
+    assert(s.allocate_calls == 200000);
+    assert(s.objects_now    == 0);
+}
+
+void test_latency()
+{
+    // Calls are not timed by default.
+
+    X a;                                    assert(!a.is_timing());
+    XX::deallocate(a, XX::allocate(a, 1), 1);
+    assert(a.allocate_latency().count()   == 0);
+    assert(a.deallocate_latency().count() == 0);
+
+    // Once timing starts, every sampled call is timed, and timing is shared
+    // by the copy group.
+
+    unbuggy::latency_options o;
+    o.sample_period = 2;
+    a.time_calls(o);                        assert(a.is_timing());
+
+    unbuggy::info_allocator<C> c( a );      assert(c.is_timing());
+    for (int i = 0; i < 4; ++i)
+        XX::deallocate(a, XX::allocate(a, 1), 1);
+    c.deallocate(c.allocate(2), 2);
+
+    assert(a.allocate_calls() == 6);        // calls 2 and 4 are timed
+    assert(a.allocate_latency().count()   == 2);
+    assert(a.deallocate_latency().count() == 2);
+    assert(c.allocate_latency().count()   == 2);
+
+    // Restarting discards latencies.  The slow-call hook receives the size,
+    // in bytes, of each slow call; a threshold of 0 makes every call slow.
+
+    std::size_t slow_bytes = 0;
+    o.sample_period     = 1;
+    o.slow_threshold    = 0;
+    o.slow_call_context = &slow_bytes;
+    o.slow_call         = [](
+            void*                      context
+          , unbuggy::latency_operation op
+          , std::uint64_t
+          , std::size_t                n)
+    {
+        if (op == unbuggy::latency_operation::allocate)
+            *static_cast<std::size_t*>(context) += n;
+    };
+    c.time_calls(o);
+    assert(a.allocate_latency().count() == 0);
+
+    c.deallocate(c.allocate(3), 3);
+    assert(a.allocate_latency().count() == 1);
+    assert(slow_bytes == 3 * sizeof(C));
+
+    // Stopping discards latencies.
+
+    a.stop_timing();                        assert(!c.is_timing());
+    assert(c.allocate_latency().count() == 0);
+}
+
 int main()
 {
     test_standard_requirements();
     test_further_requirements();
+    test_snapshot();
+    test_concurrent_snapshot();
+    test_latency();
 }
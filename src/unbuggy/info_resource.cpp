@@ -0,0 +1,152 @@
+/// @file info_resource.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include "unbuggy/info_resource.hpp"
+
+namespace unbuggy {
+
+info_resource::info_resource( std::pmr::memory_resource* upstream )
+  : m_upstream( upstream )
+  , m_shared( )
+{ }
+
+info_resource::~info_resource()
+{
+    delete m_shared.monitor;
+}
+
+std::pmr::memory_resource* info_resource::upstream_resource() const
+{
+    return m_upstream;
+}
+
+info_resource::size_type info_resource::allocate_calls() const
+{
+    return info_allocator_details::read(m_shared.allocate_calls);
+}
+
+info_resource::size_type info_resource::deallocate_calls() const
+{
+    return info_allocator_details::read(m_shared.deallocate_calls);
+}
+
+info_resource::size_type info_resource::objects_all() const
+{
+    return info_allocator_details::read(m_shared.objects_all);
+}
+
+info_resource::size_type info_resource::objects_max() const
+{
+    return info_allocator_details::read(m_shared.objects_max);
+}
+
+info_resource::size_type info_resource::objects_now() const
+{
+    return info_allocator_details::read(m_shared.objects_now);
+}
+
+info_resource::size_type info_resource::memory_all() const
+{
+    return info_allocator_details::read(m_shared.memory_all);
+}
+
+info_resource::size_type info_resource::memory_max() const
+{
+    return info_allocator_details::read(m_shared.memory_max);
+}
+
+info_resource::size_type info_resource::memory_now() const
+{
+    return info_allocator_details::read(m_shared.memory_now);
+}
+
+info_snapshot<info_resource::size_type> info_resource::snapshot() const
+{
+    return info_allocator_details::snapshot(m_shared);
+}
+
+void info_resource::reset_peaks()
+{
+    info_allocator_details::reset_peaks(m_shared);
+}
+
+info_snapshot<info_resource::size_type>
+info_resource::snapshot_and_reset_peaks()
+{
+    return info_allocator_details::snapshot_and_reset_peaks(m_shared);
+}
+
+void info_resource::time_calls(latency_options const& options)
+{
+    latency_monitor* m = new latency_monitor( options );    // may throw
+    delete m_shared.monitor;
+    m_shared.monitor = m;
+}
+
+void info_resource::stop_timing()
+{
+    delete m_shared.monitor;
+    m_shared.monitor = nullptr;
+}
+
+bool info_resource::is_timing() const
+{
+    return m_shared.monitor != nullptr;
+}
+
+latency_histogram info_resource::allocate_latency() const
+{
+    return m_shared.monitor
+         ? m_shared.monitor->histogram(latency_operation::allocate)
+         : latency_histogram( );
+}
+
+latency_histogram info_resource::deallocate_latency() const
+{
+    return m_shared.monitor
+         ? m_shared.monitor->histogram(latency_operation::deallocate)
+         : latency_histogram( );
+}
+
+void info_resource::record_deallocate(std::size_t bytes)
+{
+    info_allocator_details::record_deallocate(m_shared, size_type(1), bytes);
+}
+
+void* info_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* r = info_allocator_details::timed_call(
+            m_shared.monitor
+          , m_shared.allocate_calls
+          , latency_operation::allocate
+          , bytes
+          , [&] { return m_upstream->allocate(bytes, alignment); });
+
+    info_allocator_details::record_allocate(m_shared, size_type(1), bytes);
+
+    return r;
+}
+
+void info_resource::do_deallocate(
+        void*       p
+      , std::size_t bytes
+      , std::size_t alignment)
+{
+    info_allocator_details::timed_call(
+            m_shared.monitor
+          , m_shared.deallocate_calls
+          , latency_operation::deallocate
+          , bytes
+          , [&] { m_upstream->deallocate(p, bytes, alignment); });
+
+    info_allocator_details::record_deallocate(m_shared, size_type(1), bytes);
+}
+
+bool info_resource::do_is_equal(
+        std::pmr::memory_resource const& other) const noexcept
+{
+    return this == &other;
+}
+
+}  /// \namespace unbuggy
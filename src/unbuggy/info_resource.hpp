@@ -0,0 +1,169 @@
+/// \file info_resource.hpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#ifndef INCLUDED_UNBUGGY_INFO_RESOURCE
+#define INCLUDED_UNBUGGY_INFO_RESOURCE
+
+#include "unbuggy/info_allocator.hpp"
+#include "unbuggy/latency_histogram.hpp"
+
+#include <cstddef>          // size_t
+#include <memory_resource>  // memory_resource, get_default_resource
+
+namespace unbuggy {
+
+/// A memory resource that records simple statistics.  Forwards requests to an
+/// upstream \c std::pmr::memory_resource supplied at construction, and
+/// records the same statistics as \c info_allocator, with the same accessors.
+/// Since an \c info_resource is selected at run time rather than compile
+/// time, containers using it through \c std::pmr::polymorphic_allocator share
+/// a single instantiation regardless of how their memory is managed, and
+/// resources may be composed freely; for example, an \c info_resource may
+/// measure the upstream requests of a \c pool_resource that itself records
+/// the requests of its users.
+///
+/// Each allocated block counts as one object, and memory is measured in
+/// bytes.  As with \c info_allocator, statistics may be read, snapshot, and
+/// reset from any thread without blocking allocation, at the same cost to
+/// writers, and a sample of the calls this resource forwards may optionally
+/// be timed.  Allocation and deallocation
+/// must not be called concurrently with one another.
+///
+/// \see INCITS-ISO-IEC-14882-2017 [mem.res.class]
+///
+class info_resource: public std::pmr::memory_resource {
+
+  public:
+
+    typedef std::size_t size_type;
+        ///< the type of all statistics
+
+  private:
+
+    typedef info_allocator_details::shared_state<size_type> shared_state;
+        ///< for brevity in later code
+
+    std::pmr::memory_resource* m_upstream;  ///< source of all memory
+    shared_state               m_shared;    ///< statistics
+
+  public:
+
+    explicit info_resource(
+            std::pmr::memory_resource* upstream =
+                std::pmr::get_default_resource());
+        ///< Decorates \a upstream, which must outlive this object.  \a
+        /// upstream is not used during construction, and so may be a resource
+        /// not yet constructed.
+
+    info_resource( info_resource const& ) = delete;
+    info_resource& operator=( info_resource const& ) = delete;
+
+    ~info_resource();
+        ///< Destroys this object.  Does not release memory allocated from the
+        /// upstream resource.
+
+    virtual std::pmr::memory_resource* upstream_resource() const;
+        ///< Returns the decorated resource.  Derived resources that decorate
+        /// a resource of their own override this function to return the
+        /// upstream resource of that resource instead, so that it is never
+        /// exposed, even through a reference to \c info_resource.
+
+    size_type allocate_calls() const;
+        ///< Returns the number of calls to \c allocate.
+
+    size_type deallocate_calls() const;
+        ///< Returns the number of calls to \c deallocate.
+
+    size_type objects_all() const;
+        ///< Returns the total number of blocks allocated.  The result
+        /// includes blocks that have been deallocated.
+
+    size_type objects_max() const;
+        ///< Returns the most simultaneous live blocks seen.
+
+    size_type objects_now() const;
+        ///< Returns the number of currently live blocks.
+
+    size_type memory_all() const;
+        ///< Returns the total number of bytes allocated.  The result includes
+        /// memory that has been deallocated.
+
+    size_type memory_max() const;
+        ///< Returns the highest number of live bytes allocated at any time.
+
+    size_type memory_now() const;
+        ///< Returns the number of currently live bytes.
+
+    info_snapshot<size_type> snapshot() const;
+        ///< Returns the statistics of this resource as of a single instant.
+        /// May be called concurrently with allocation and deallocation,
+        /// which it never blocks.
+
+    void reset_peaks();
+        ///< Lowers \c objects_max and \c memory_max to the current values of
+        /// \c objects_now and \c memory_now.  May be called concurrently with
+        /// allocation and deallocation, and with other resets.
+
+    info_snapshot<size_type> snapshot_and_reset_peaks();
+        ///< Returns the statistics of this resource as of a single instant,
+        /// and resets peaks as by \c reset_peaks, as one operation.  May be
+        /// called concurrently as \c reset_peaks.
+
+    void time_calls(latency_options const& options =latency_options( ));
+        ///< Starts timing a sample of the calls this resource forwards, as
+        /// configured by \a options, discarding any latencies previously
+        /// recorded.  An \c info_resource forwards calls to its upstream
+        /// resource; \c pool_resource and \c arena_resource forward them to
+        /// the \c std::pmr resource they wrap, so that the pool or arena's
+        /// own work is timed along with any upstream calls it makes, and \c
+        /// arena_resource forwards no deallocations.  Timing state is
+        /// allocated from the global heap.  Must not be called concurrently
+        /// with other functions.
+
+    void stop_timing();
+        ///< Stops timing forwarded calls, and discards all recorded
+        /// latencies.  Must not be called concurrently with other functions.
+
+    bool is_timing() const;
+        ///< Returns \c true if forwarded calls are timed.
+
+    latency_histogram allocate_latency() const;
+        ///< Returns the latencies, in ticks of \c cycle_count, of the timed
+        /// forwarded calls to \c allocate.
+
+    latency_histogram deallocate_latency() const;
+        ///< Returns the latencies, in ticks of \c cycle_count, of the timed
+        /// forwarded calls to \c deallocate.
+
+  protected:
+
+    void record_deallocate(std::size_t bytes);
+        ///< Records the deallocation of one block of \a bytes, without
+        /// returning it to the upstream resource.  Derived resources whose
+        /// upstream resource reclaims nothing on deallocation call this
+        /// function in place of \c do_deallocate.
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        ///< Returns \a bytes of memory aligned to \a alignment, allocated from
+        /// the upstream resource, or throws an exception if the memory cannot
+        /// be allocated.
+
+    void do_deallocate(
+            void*       p
+          , std::size_t bytes
+          , std::size_t alignment) override;
+        ///< Returns to the upstream resource the memory at \a p, which must
+        /// have been returned by a previous call to \c allocate with the same
+        /// \a bytes and \a alignment, and not yet deallocated.
+
+    bool do_is_equal(
+            std::pmr::memory_resource const& other) const noexcept override;
+        ///< Returns \c true if \a other is this object.  Memory allocated
+        /// from an \c info_resource must be deallocated by the same resource
+        /// for its statistics to be correct.
+};
+
+}  /// \namespace unbuggy
+
+#endif
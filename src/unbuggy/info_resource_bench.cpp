@@ -0,0 +1,142 @@
+/// @file info_resource_bench.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+// Compares the cost of counting allocations through the compile-time
+// info_allocator with that of counting them through an info_resource, both
+// through an opaque memory_resource pointer (virtual dispatch) and through a
+// local object whose type the compiler knows (so that it may devirtualize).
+// All variants draw from the global heap through the same unaligned
+// operator new, so that they differ only in how they count.  Each allocates
+// and deallocates batches of small blocks, and reports nanoseconds per
+// allocate/deallocate pair.
+
+#include "unbuggy/info_resource.hpp"
+
+#include <chrono>           // steady_clock
+#include <cstddef>          // size_t
+#include <iostream>         // cout
+#include <memory>           // allocator_traits
+#include <memory_resource>  // memory_resource
+#include <new>              // operator new, operator delete
+
+namespace {
+
+std::size_t const batch       = 64;
+std::size_t const repetitions = 200000;
+std::size_t const block_size  = 32;
+
+struct block {
+    char bytes[block_size];
+};
+
+// A resource drawing from the global heap exactly as std::allocator does,
+// without the aligned operator new used by new_delete_resource.
+//
+class heap_resource final: public std::pmr::memory_resource {
+
+    void* do_allocate(std::size_t bytes, std::size_t) override
+    {
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override
+    {
+        ::operator delete(p);
+    }
+
+    bool do_is_equal(
+            std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+// Returns the nanoseconds per pair of allocations through the specified
+// allocator.
+//
+template <typename Allocator>
+double bench_allocator(Allocator& a)
+{
+    typedef std::allocator_traits<Allocator> traits;
+
+    typename traits::pointer p[batch];
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        for (std::size_t i = 0; i < batch; ++i)
+            p[i] = traits::allocate(a, 1);
+        for (std::size_t i = 0; i < batch; ++i)
+            traits::deallocate(a, p[i], 1);
+    }
+    return seconds_since(start) * 1e9 / (batch * repetitions);
+}
+
+// Returns the nanoseconds per pair of allocations through the specified
+// resource, whose dynamic type is opaque to the compiler.
+//
+__attribute__((noinline))
+double bench_resource(std::pmr::memory_resource* m)
+{
+    void* p[batch];
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        for (std::size_t i = 0; i < batch; ++i)
+            p[i] = m->allocate(block_size, alignof(block));
+        for (std::size_t i = 0; i < batch; ++i)
+            m->deallocate(p[i], block_size, alignof(block));
+    }
+    return seconds_since(start) * 1e9 / (batch * repetitions);
+}
+
+// Returns the nanoseconds per pair of allocations through a local
+// info_resource decorating the specified upstream resource, whose dynamic
+// type is known to the compiler.  Loads the specified count with the number
+// of allocations made.
+//
+__attribute__((noinline))
+double bench_known(heap_resource& upstream, std::size_t& count)
+{
+    unbuggy::info_resource m( &upstream );
+
+    void* p[batch];
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        for (std::size_t i = 0; i < batch; ++i)
+            p[i] = m.allocate(block_size, alignof(block));
+        for (std::size_t i = 0; i < batch; ++i)
+            m.deallocate(p[i], block_size, alignof(block));
+    }
+    double t = seconds_since(start) * 1e9 / (batch * repetitions);
+
+    count = m.allocate_calls();
+    return t;
+}
+
+}  // close unnamed namespace
+
+int main()
+{
+    heap_resource                  heap;
+    unbuggy::info_allocator<block> a;
+    unbuggy::info_resource         r( &heap );
+    std::size_t                    k;
+
+    double ta = bench_allocator(a);
+    double tr = bench_resource(&r);
+    double tk = bench_known(heap, k);
+
+    std::cout << "info_allocator:         " << ta << " ns/pair\n"
+              << "info_resource, virtual: " << tr << " ns/pair\n"
+              << "info_resource, known:   " << tk << " ns/pair\n";
+
+    return a.allocate_calls() == r.allocate_calls()
+        && r.allocate_calls() == k ? 0 : 1;
+}
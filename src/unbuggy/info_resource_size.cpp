@@ -0,0 +1,91 @@
+/// @file info_resource_size.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+// Measures the code generated for containers counting their allocations.
+// Each of 20 element types is held in a vector and a list.  Built without
+// UNBUGGY_SIZE_PMR, each container uses its own info_allocator
+// instantiation; built with it, all containers use polymorphic_allocator
+// over a single info_resource.  "make size" builds both objects, and
+// reports their sizes alongside that of info_resource itself.
+
+#include "unbuggy/info_resource.hpp"
+
+#include <cstddef>          // size_t
+#include <list>             // list, pmr::list
+#include <utility>          // index_sequence
+#include <vector>           // vector, pmr::vector
+
+namespace {
+
+template <std::size_t N>
+struct element {
+    int values[N % 4 + 1];
+};
+
+#ifdef UNBUGGY_SIZE_PMR
+
+template <std::size_t N>
+std::size_t exercise(unbuggy::info_resource& r)
+{
+    std::pmr::vector<element<N> > v( &r );
+    std::pmr::list<element<N> >   l( &r );
+
+    v.push_back(element<N>( ));
+    l.push_back(element<N>( ));
+    return v.size() + l.size();
+}
+
+template <std::size_t... N>
+std::size_t exercise_all(unbuggy::info_resource& r, std::index_sequence<N...>)
+{
+    std::size_t sizes[] = { exercise<N>(r)... };
+    std::size_t total   = 0;
+    for (std::size_t s: sizes)
+        total += s;
+    return total + r.allocate_calls();
+}
+
+}  // close unnamed namespace
+
+std::size_t exercise_containers(unbuggy::info_resource& r)
+{
+    return exercise_all(r, std::make_index_sequence<20>( ));
+}
+
+#else
+
+template <std::size_t N>
+std::size_t exercise()
+{
+    typedef unbuggy::info_allocator<element<N> > allocator;
+
+    allocator                             a;
+    std::vector<element<N>, allocator>    v( a );
+    std::list<element<N>, allocator>      l( a );
+
+    v.push_back(element<N>( ));
+    l.push_back(element<N>( ));
+    return v.size() + l.size() + a.allocate_calls();
+}
+
+template <std::size_t... N>
+std::size_t exercise_all(std::index_sequence<N...>)
+{
+    std::size_t sizes[] = { exercise<N>()... };
+    std::size_t total   = 0;
+    for (std::size_t s: sizes)
+        total += s;
+    return total;
+}
+
+}  // close unnamed namespace
+
+std::size_t exercise_containers()
+{
+    return exercise_all(std::make_index_sequence<20>( ));
+}
+
+#endif
@@ -0,0 +1,195 @@
+/// @file info_resource_test.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+#include "unbuggy/info_resource.hpp"
+#include "unbuggy/info_window.hpp"
+
+#include <atomic>           // atomic
+#include <cassert>          // assert
+#include <memory_resource>  // polymorphic_allocator, null_memory_resource
+#include <new>              // bad_alloc
+#include <string>           // pmr::string
+#include <thread>           // thread
+#include <vector>           // pmr::vector
+
+using unbuggy::info_resource;
+
+void test_counts()
+{
+    info_resource r;
+    assert(r.upstream_resource() == std::pmr::get_default_resource());
+    assert(r.is_equal(r));
+    assert(!r.is_equal(*std::pmr::get_default_resource()));
+
+    // Each block counts as one object, and memory is counted in bytes.
+
+    void* p = r.allocate(24, 8);
+    assert(r.allocate_calls()   == 1);
+    assert(r.deallocate_calls() == 0);
+    assert(r.objects_all()      == 1);
+    assert(r.objects_now()      == 1);
+    assert(r.memory_all()       == 24);
+    assert(r.memory_now()       == 24);
+
+    void* q = r.allocate(100, 16);
+    assert(r.allocate_calls()   == 2);
+    assert(r.objects_max()      == 2);
+    assert(r.memory_max()       == 124);
+
+    r.deallocate(p, 24, 8);
+    assert(r.deallocate_calls() == 1);
+    assert(r.objects_now()      == 1);
+    assert(r.memory_now()       == 100);
+    assert(r.memory_max()       == 124);
+
+    // Snapshots and peak resets behave as for info_allocator.
+
+    unbuggy::info_snapshot<std::size_t> s = r.snapshot();
+    assert(s.allocate_calls     == 2);
+    assert(s.memory_all         == 124);
+    assert(s.memory_max         == 124);
+    assert(s.memory_now         == 100);
+
+    r.reset_peaks();
+    assert(r.memory_max()       == 100);
+    assert(r.objects_max()      == 1);
+
+    void* t = r.allocate(50, 8);
+    r.deallocate(t, 50, 8);
+    s = r.snapshot_and_reset_peaks();
+    assert(s.memory_max         == 150);
+    assert(r.memory_max()       == 100);
+
+    r.deallocate(q, 100, 16);
+    assert(r.memory_now()       == 0);
+    assert(r.memory_all()       == 174);
+}
+
+void test_failure()
+{
+    // A failed upstream allocation is not counted.
+
+    info_resource r( std::pmr::null_memory_resource() );
+    try {
+        (void)r.allocate(1);
+        assert(!"allocation from the null resource must fail");
+    }
+    catch (std::bad_alloc const&) {
+    }
+    assert(r.allocate_calls() == 0);
+    assert(r.memory_now()     == 0);
+}
+
+void test_containers()
+{
+    // Containers of any type share the resource through polymorphic
+    // allocators, and their nested allocations are counted too.
+
+    info_resource r;
+    {
+        std::pmr::vector<std::pmr::string> v( &r );
+        v.emplace_back("a string long enough to need its own allocation");
+        assert(r.objects_now() == 2);
+        assert(r.memory_now()  >  sizeof(std::pmr::string));
+    }
+    assert(r.objects_now() == 0);
+    assert(r.allocate_calls() == r.deallocate_calls());
+
+    // Resources compose at run time: here one info_resource measures the
+    // requests forwarded by another.
+
+    info_resource upstream;
+    info_resource downstream( &upstream );
+    std::pmr::vector<int> w( 10, 0, &downstream );
+    assert(downstream.memory_now() == 10 * sizeof(int));
+    assert(upstream.memory_now()   == 10 * sizeof(int));
+
+    // An info_window may observe a resource.
+
+    unbuggy::info_window<std::size_t, 4> window( downstream );
+    w.resize(1000);
+    window.advance(downstream);
+    assert(window[0].stats.allocate_calls   == 1);
+    assert(window[0].stats.deallocate_calls == 1);
+    assert(window[0].stats.memory_now       == 1000 * sizeof(int));
+}
+
+// Asserts that the specified snapshot, taken while a writer allocates and
+// immediately deallocates blocks of between 8 and 56 bytes, is consistent.
+//
+void check_consistent(unbuggy::info_snapshot<std::size_t> const& s)
+{
+    assert(s.allocate_calls - s.deallocate_calls == s.objects_now);
+    assert(s.objects_now <= 1);
+    assert(s.objects_now == 0 ? s.memory_now == 0
+                              : s.memory_now >= 8 && s.memory_now <= 56);
+    assert(s.memory_now % 8 == 0);
+    assert(s.memory_max >= s.memory_now && s.memory_max <= 56);
+}
+
+void test_concurrent_snapshot()
+{
+    // A window may advance, and snapshots may be taken, from other threads
+    // while one thread allocates.
+
+    info_resource     r;
+    std::atomic<bool> done( false );
+
+    std::thread writer([&] {
+        for (std::size_t i = 0; i < 200000; ++i) {
+            std::size_t n = 8 * (1 + i % 7);
+            r.deallocate(r.allocate(n), n);
+        }
+        done = true;
+    });
+
+    std::thread monitor([&] {
+        unbuggy::info_window<std::size_t, 4> window( r );
+        while (!done) {
+            window.advance(r);
+
+            unbuggy::info_snapshot<std::size_t> const& s = window[0].stats;
+            assert(s.objects_now <= 1);
+            assert(s.memory_max  >= s.memory_now && s.memory_max <= 56);
+        }
+    });
+
+    while (!done)
+        check_consistent(r.snapshot());
+
+    writer.join();
+    monitor.join();
+
+    assert(r.allocate_calls() == 200000);
+    assert(r.objects_now()    == 0);
+}
+
+void test_latency()
+{
+    info_resource r;                        assert(!r.is_timing());
+
+    unbuggy::latency_options o;
+    o.sample_period = 2;
+    r.time_calls(o);                        assert(r.is_timing());
+
+    for (int i = 0; i < 4; ++i)
+        r.deallocate(r.allocate(8), 8);
+
+    assert(r.allocate_latency().count()   == 2);
+    assert(r.deallocate_latency().count() == 2);
+
+    r.stop_timing();                        assert(!r.is_timing());
+    assert(r.allocate_latency().count() == 0);
+}
+
+int main()
+{
+    test_counts();
+    test_failure();
+    test_containers();
+    test_concurrent_snapshot();
+    test_latency();
+}
@@ -0,0 +1,5 @@
+/// @file info_window.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include "unbuggy/info_window.hpp"
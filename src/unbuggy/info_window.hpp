@@ -0,0 +1,124 @@
+/// \file info_window.hpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#ifndef INCLUDED_UNBUGGY_INFO_WINDOW
+#define INCLUDED_UNBUGGY_INFO_WINDOW
+
+#include "unbuggy/info_allocator.hpp"
+
+#include <chrono>   // steady_clock
+#include <cstddef>  // size_t
+
+namespace unbuggy {
+
+/// The statistics of one or more consecutive intervals, as recorded by an \c
+/// info_window.  Members of \c stats have the following meanings:
+///
+/// - \c allocate_calls, \c deallocate_calls, \c objects_all, and \c
+///   memory_all count only the calls, objects, and memory of the interval
+/// - \c objects_max and \c memory_max are the peaks within the interval
+/// - \c objects_now and \c memory_now are the values at the interval's end
+///
+/// \param Size_type the size type of the observed allocator
+///
+template <typename Size_type>
+struct info_interval {
+
+    typedef std::chrono::steady_clock::duration duration;
+        ///< the type of \c elapsed
+
+    duration                 elapsed;   ///< length of the interval
+    info_snapshot<Size_type> stats;     ///< statistics of the interval
+
+    double allocate_rate() const;
+        ///< Returns the number of calls to \c allocate per second.
+
+    double deallocate_rate() const;
+        ///< Returns the number of calls to \c deallocate per second.
+
+    double memory_rate() const;
+        ///< Returns the amount of memory allocated per second.
+};
+
+/// A fixed-size ring of the statistics of consecutive intervals, recorded
+/// from any object having the \c snapshot_and_reset_peaks function of \c
+/// info_allocator.  Each call to \c advance closes the current interval:
+/// it takes a snapshot of the observed statistics, records the difference
+/// from the previous snapshot, and resets peaks so that the next interval
+/// measures its own.  The snapshot and reset are a single operation, so no
+/// peak between them is lost.  Once \c Capacity intervals have been
+/// recorded, each call to \c advance discards the oldest.
+///
+/// An \c info_window is typically advanced periodically by a monitoring
+/// thread.  Advancing never blocks the observed allocators, but resetting
+/// peaks writes to counters they update, so an allocation concurrent with an
+/// advance may miss in cache.  A window is not itself safe for concurrent
+/// use.
+///
+/// \param Size_type the size type of the observed allocator
+/// \param Capacity the number of intervals retained
+///
+template <typename Size_type, std::size_t Capacity>
+class info_window {
+
+    static_assert(Capacity > 0, "an info_window must hold an interval");
+
+  public:
+
+    typedef std::chrono::steady_clock::time_point time_point;
+        ///< the type of interval boundaries
+
+  private:
+
+    info_interval<Size_type>  m_ring[Capacity]; ///< recorded intervals
+    std::size_t               m_next;           ///< index of next interval
+    std::size_t               m_size;           ///< number of intervals
+    info_snapshot<Size_type>  m_last;           ///< snapshot at last advance
+    time_point                m_last_time;      ///< time of last advance
+
+  public:
+
+    template <typename Source>
+    explicit info_window( Source& source );
+        ///< Creates an empty window, and starts its first interval by taking
+        /// a snapshot of, and resetting the peaks of, \a source.
+
+    info_window( info_snapshot<Size_type> const& start, time_point now );
+        ///< Creates an empty window whose first interval starts at time \a
+        /// now with the statistics \a start.
+
+    template <typename Source>
+    void advance(Source& source);
+        ///< Ends the current interval by taking a snapshot of \a source, and
+        /// starts the next by resetting the peaks of \a source, as one
+        /// operation.
+
+    void advance(info_snapshot<Size_type> const& end, time_point now);
+        ///< Ends the current interval at time \a now with the statistics \a
+        /// end, which must have been taken since the peaks of the observed
+        /// allocator were last reset.
+
+    static constexpr std::size_t capacity();
+        ///< Returns the maximum number of intervals retained.
+
+    std::size_t size() const;
+        ///< Returns the number of intervals retained.
+
+    info_interval<Size_type> const& operator[](std::size_t age) const;
+        ///< Returns the interval that ended \a age intervals before the most
+        /// recent.  The behavior is undefined unless <code>age <
+        /// size()</code>.
+
+    info_interval<Size_type> total(std::size_t count) const;
+        ///< Returns the combination of the \a count most recent intervals, or
+        /// of all retained intervals if fewer.  Counts are summed, peaks are
+        /// the greatest of the intervals, and current values are those of
+        /// the most recent interval.  Returns an interval of zero length if
+        /// no intervals are retained.
+};
+
+}  /// \namespace unbuggy
+
+#include "unbuggy/info_window.tpp"
+#endif
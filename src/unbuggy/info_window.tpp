@@ -0,0 +1,152 @@
+/// \file info_window.tpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include <cassert>  // assert
+
+namespace unbuggy {
+
+/// \cond DETAILS
+
+namespace info_window_details {
+
+// Returns the specified count divided by the specified duration in seconds,
+// or 0 if the duration is not positive.
+//
+template <typename Size_type>
+double per_second(Size_type count, std::chrono::steady_clock::duration d)
+{
+    double seconds = std::chrono::duration<double>(d).count();
+    return seconds > 0 ? count / seconds : 0;
+}
+
+}  // namespace info_window_details
+
+/// \endcond
+
+template <typename Size_type>
+double info_interval<Size_type>::allocate_rate() const
+{
+    return info_window_details::per_second(stats.allocate_calls, elapsed);
+}
+
+template <typename Size_type>
+double info_interval<Size_type>::deallocate_rate() const
+{
+    return info_window_details::per_second(stats.deallocate_calls, elapsed);
+}
+
+template <typename Size_type>
+double info_interval<Size_type>::memory_rate() const
+{
+    return info_window_details::per_second(stats.memory_all, elapsed);
+}
+
+template <typename Size_type, std::size_t Capacity>
+template <typename Source>
+info_window<Size_type, Capacity>::info_window( Source& source )
+  : m_ring( )
+  , m_next( 0 )
+  , m_size( 0 )
+  , m_last( source.snapshot_and_reset_peaks() )
+  , m_last_time( std::chrono::steady_clock::now() )
+{ }
+
+template <typename Size_type, std::size_t Capacity>
+info_window<Size_type, Capacity>::info_window(
+        info_snapshot<Size_type> const& start
+      , time_point                      now)
+  : m_ring( )
+  , m_next( 0 )
+  , m_size( 0 )
+  , m_last( start )
+  , m_last_time( now )
+{ }
+
+template <typename Size_type, std::size_t Capacity>
+template <typename Source>
+void info_window<Size_type, Capacity>::advance(Source& source)
+{
+    advance(
+            source.snapshot_and_reset_peaks()
+          , std::chrono::steady_clock::now());
+}
+
+template <typename Size_type, std::size_t Capacity>
+void info_window<Size_type, Capacity>::advance(
+        info_snapshot<Size_type> const& end
+      , time_point                      now)
+{
+    info_interval<Size_type>& r = m_ring[m_next];
+
+    r.elapsed                = now - m_last_time;
+    r.stats.allocate_calls   = end.allocate_calls   - m_last.allocate_calls;
+    r.stats.deallocate_calls = end.deallocate_calls - m_last.deallocate_calls;
+    r.stats.objects_all      = end.objects_all      - m_last.objects_all;
+    r.stats.objects_max      = end.objects_max;
+    r.stats.objects_now      = end.objects_now;
+    r.stats.memory_all       = end.memory_all       - m_last.memory_all;
+    r.stats.memory_max       = end.memory_max;
+    r.stats.memory_now       = end.memory_now;
+
+    m_last      = end;
+    m_last_time = now;
+    m_next      = (m_next + 1) % Capacity;
+    if (m_size < Capacity)
+        ++m_size;
+}
+
+template <typename Size_type, std::size_t Capacity>
+constexpr std::size_t info_window<Size_type, Capacity>::capacity()
+{
+    return Capacity;
+}
+
+template <typename Size_type, std::size_t Capacity>
+std::size_t info_window<Size_type, Capacity>::size() const
+{
+    return m_size;
+}
+
+template <typename Size_type, std::size_t Capacity>
+info_interval<Size_type> const&
+info_window<Size_type, Capacity>::operator[](std::size_t age) const
+{
+    assert(age < m_size);
+
+    return m_ring[(m_next + Capacity - 1 - age) % Capacity];
+}
+
+template <typename Size_type, std::size_t Capacity>
+info_interval<Size_type>
+info_window<Size_type, Capacity>::total(std::size_t count) const
+{
+    info_interval<Size_type> r = info_interval<Size_type>( );
+
+    if (count > m_size)
+        count = m_size;
+
+    if (count) {
+        r.stats.objects_now = (*this)[0].stats.objects_now;
+        r.stats.memory_now  = (*this)[0].stats.memory_now;
+    }
+
+    for (std::size_t age = 0; age < count; ++age) {
+        info_interval<Size_type> const& i = (*this)[age];
+
+        r.elapsed                += i.elapsed;
+        r.stats.allocate_calls   += i.stats.allocate_calls;
+        r.stats.deallocate_calls += i.stats.deallocate_calls;
+        r.stats.objects_all      += i.stats.objects_all;
+        r.stats.memory_all       += i.stats.memory_all;
+
+        if (i.stats.objects_max > r.stats.objects_max)
+            r.stats.objects_max = i.stats.objects_max;
+        if (i.stats.memory_max > r.stats.memory_max)
+            r.stats.memory_max = i.stats.memory_max;
+    }
+
+    return r;
+}
+
+}  /// \namespace unbuggy
@@ -0,0 +1,126 @@
+/// @file info_window_test.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+#include "unbuggy/info_window.hpp"
+
+#include <cassert>      // assert
+#include <chrono>       // seconds
+#include <cstddef>      // size_t
+
+typedef unbuggy::info_snapshot<std::size_t>     S;
+typedef unbuggy::info_window<std::size_t, 3>    W;
+typedef std::allocator_traits<
+            unbuggy::info_allocator<int> >      XX;
+
+// Returns a snapshot having the specified call counts and peaks, with object
+// and memory counts derived from the calls.
+//
+S make_snapshot(std::size_t allocs, std::size_t deallocs, std::size_t max)
+{
+    S r;
+    r.allocate_calls   = allocs;
+    r.deallocate_calls = deallocs;
+    r.objects_all      = allocs;
+    r.objects_max      = max;
+    r.objects_now      = allocs - deallocs;
+    r.memory_all       = allocs * 4;
+    r.memory_max       = max * 4;
+    r.memory_now       = (allocs - deallocs) * 4;
+    return r;
+}
+
+void test_intervals()
+{
+    W::time_point t0;
+    std::chrono::seconds one( 1 );
+
+    W w( make_snapshot(10, 5, 5), t0 );
+    assert(W::capacity() == 3);
+    assert(w.size() == 0);
+    assert(w.total(10).elapsed.count() == 0);
+
+    // Each interval records the differences of counts, and the peaks and
+    // current values at its end.
+
+    w.advance(make_snapshot(30, 10, 20), t0 + one);
+    assert(w.size() == 1);
+    assert(w[0].elapsed == one);
+    assert(w[0].stats.allocate_calls   == 20);
+    assert(w[0].stats.deallocate_calls ==  5);
+    assert(w[0].stats.objects_all      == 20);
+    assert(w[0].stats.objects_max      == 20);
+    assert(w[0].stats.objects_now      == 20);
+    assert(w[0].stats.memory_all       == 80);
+    assert(w[0].allocate_rate()        == 20);
+    assert(w[0].deallocate_rate()      ==  5);
+    assert(w[0].memory_rate()          == 80);
+
+    w.advance(make_snapshot(40, 30, 22), t0 + 3 * one);
+    assert(w.size() == 2);
+    assert(w[0].elapsed == 2 * one);
+    assert(w[0].stats.allocate_calls   == 10);
+    assert(w[0].stats.deallocate_calls == 20);
+    assert(w[0].stats.objects_max      == 22);
+    assert(w[0].stats.objects_now      == 10);
+    assert(w[0].allocate_rate()        ==  5);
+    assert(w[1].stats.allocate_calls   == 20);
+
+    // Totals sum counts and take the greatest peak.
+
+    unbuggy::info_interval<std::size_t> t = w.total(2);
+    assert(t.elapsed == 3 * one);
+    assert(t.stats.allocate_calls   == 30);
+    assert(t.stats.deallocate_calls == 25);
+    assert(t.stats.objects_max      == 22);
+    assert(t.stats.objects_now      == 10);
+    assert(t.allocate_rate()        == 10);
+    assert(w.total(10).stats.allocate_calls == 30);
+
+    // Once full, the oldest interval is discarded.
+
+    w.advance(make_snapshot(41, 30, 11), t0 + 4 * one);
+    w.advance(make_snapshot(43, 30, 13), t0 + 5 * one);
+    assert(w.size() == 3);
+    assert(w[0].stats.allocate_calls == 2);
+    assert(w[1].stats.allocate_calls == 1);
+    assert(w[2].stats.allocate_calls == 10);
+    assert(w.total(3).stats.objects_max == 22);
+}
+
+void test_allocator()
+{
+    // A window observing an allocator measures the peak within each
+    // interval, rather than since construction.
+
+    unbuggy::info_allocator<int> a;
+    int* p = XX::allocate(a, 8);
+    XX::deallocate(a, p, 8);
+
+    W w( a );
+    assert(a.objects_max() == 0);           // reset by the window
+
+    p = XX::allocate(a, 2);
+    w.advance(a);
+    assert(w[0].stats.allocate_calls == 1);
+    assert(w[0].stats.objects_max    == 2);
+    assert(a.objects_max()           == 2);
+
+    XX::deallocate(a, p, 2);
+    w.advance(a);
+    assert(w[0].stats.allocate_calls   == 0);
+    assert(w[0].stats.deallocate_calls == 1);
+    assert(w[0].stats.objects_max      == 2);   // live at interval start
+    assert(w[0].stats.objects_now      == 0);
+
+    w.advance(a);
+    assert(w[0].stats.objects_max == 0);
+}
+
+int main()
+{
+    test_intervals();
+    test_allocator();
+}
@@ -0,0 +1,246 @@
+/// @file latency_histogram.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include "unbuggy/latency_histogram.hpp"
+
+#include <cassert>      // assert
+
+namespace unbuggy {
+
+namespace {
+
+std::size_t const sub_bits    = 3;              // log2 of buckets per octave
+std::size_t const sub_buckets = 1 << sub_bits;  // buckets per octave
+
+// Returns the index of the highest set bit of the specified nonzero value.
+//
+unsigned highest_bit(std::uint64_t bits)
+{
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(bits);
+#else
+    unsigned r = 0;
+    while (bits >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+// Returns the stripe assigned to the calling thread.  Stripes are assigned
+// round robin, in order of each thread's first call.
+//
+std::size_t this_thread_stripe()
+{
+    static std::atomic<std::size_t> next( 0 );
+    thread_local std::size_t stripe =
+        next.fetch_add(1, std::memory_order_relaxed)
+            % latency_recorder::stripe_count;
+    return stripe;
+}
+
+// Raises the specified atomic maximum to at least the specified value.
+//
+void raise(std::atomic<std::uint64_t>& max, std::uint64_t value)
+{
+    std::uint64_t m = max.load(std::memory_order_relaxed);
+    while (m < value
+           && !max.compare_exchange_weak(m, value, std::memory_order_relaxed))
+        ;
+}
+
+}  // close unnamed namespace
+
+std::size_t const latency_histogram::bucket_count;
+std::size_t const latency_recorder::stripe_count;
+
+std::size_t latency_histogram::bucket_of(std::uint64_t ticks)
+{
+    if (ticks < sub_buckets)
+        return ticks;
+
+    unsigned e = highest_bit(ticks);    // at least sub_bits
+    return sub_buckets * (e - sub_bits + 1)
+         + (ticks >> (e - sub_bits) & (sub_buckets - 1));
+}
+
+std::uint64_t latency_histogram::bucket_limit(std::size_t bucket)
+{
+    assert(bucket < bucket_count);
+
+    if (bucket < sub_buckets)
+        return bucket;
+
+    unsigned      e     = bucket / sub_buckets + sub_bits - 1;
+    std::uint64_t width = std::uint64_t(1) << (e - sub_bits);
+    std::uint64_t lower = (sub_buckets + bucket % sub_buckets) * width;
+    return lower + (width - 1);
+}
+
+latency_histogram::latency_histogram( )
+  : m_buckets( )
+  , m_count( 0 )
+  , m_max( 0 )
+{ }
+
+void latency_histogram::record(std::uint64_t ticks)
+{
+    ++m_buckets[bucket_of(ticks)];
+    ++m_count;
+    if (ticks > m_max)
+        m_max = ticks;
+}
+
+void latency_histogram::add(
+        std::size_t     bucket
+      , std::uint64_t   count
+      , std::uint64_t   max)
+{
+    assert(bucket < bucket_count);
+
+    m_buckets[bucket] += count;
+    m_count += count;
+    if (count && max > m_max)
+        m_max = max;
+}
+
+void latency_histogram::merge(latency_histogram const& other)
+{
+    for (std::size_t i = 0; i < bucket_count; ++i)
+        m_buckets[i] += other.m_buckets[i];
+    m_count += other.m_count;
+    if (other.m_max > m_max)
+        m_max = other.m_max;
+}
+
+std::uint64_t latency_histogram::bucket(std::size_t i) const
+{
+    assert(i < bucket_count);
+
+    return m_buckets[i];
+}
+
+std::uint64_t latency_histogram::count() const
+{
+    return m_count;
+}
+
+std::uint64_t latency_histogram::max() const
+{
+    return m_max;
+}
+
+std::uint64_t latency_histogram::percentile(double fraction) const
+{
+    assert(0 <= fraction && fraction <= 1);
+
+    if (m_count == 0)
+        return 0;
+
+    // Find the first bucket at which the count of values seen reaches the
+    // rank, rounded up, of the requested fraction.
+
+    double        exact = fraction * m_count;
+    std::uint64_t rank  = exact;
+    if (rank < exact || rank == 0)
+        ++rank;
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            std::uint64_t limit = bucket_limit(i);
+            return limit < m_max ? limit : m_max;
+        }
+    }
+    return m_max;
+}
+
+std::uint64_t latency_histogram::p50() const
+{
+    return percentile(0.5);
+}
+
+std::uint64_t latency_histogram::p99() const
+{
+    return percentile(0.99);
+}
+
+std::uint64_t latency_histogram::p999() const
+{
+    return percentile(0.999);
+}
+
+latency_recorder::latency_recorder( )
+{
+    for (stripe& s: m_stripes) {
+        for (std::atomic<std::uint64_t>& b: s.buckets)
+            b.store(0, std::memory_order_relaxed);
+        s.max.store(0, std::memory_order_relaxed);
+    }
+}
+
+void latency_recorder::record(std::uint64_t ticks)
+{
+    stripe& s = m_stripes[this_thread_stripe()];
+    s.buckets[latency_histogram::bucket_of(ticks)].fetch_add(
+            1, std::memory_order_relaxed);
+    raise(s.max, ticks);
+}
+
+latency_histogram latency_recorder::histogram() const
+{
+    latency_histogram r;
+    for (stripe const& s: m_stripes) {
+        std::uint64_t max = s.max.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i)
+            r.add(i, s.buckets[i].load(std::memory_order_relaxed), max);
+    }
+    return r;
+}
+
+latency_options::latency_options( )
+  : sample_period( 1 )
+  , slow_threshold( 0 )
+  , slow_call( nullptr )
+  , slow_call_context( nullptr )
+{ }
+
+latency_monitor::latency_monitor( latency_options const& options )
+  : m_options( options )
+  , m_sample_mask( 0 )
+{
+    std::size_t period = 1;
+    while (period < m_options.sample_period)
+        period <<= 1;
+    m_options.sample_period = period;
+    m_sample_mask = period - 1;
+}
+
+latency_options const& latency_monitor::options() const
+{
+    return m_options;
+}
+
+void latency_monitor::record(
+        latency_operation   operation
+      , std::uint64_t       ticks
+      , std::size_t         n)
+{
+    if (operation == latency_operation::allocate)
+        m_allocate.record(ticks);
+    else
+        m_deallocate.record(ticks);
+
+    if (ticks >= m_options.slow_threshold && m_options.slow_call)
+        m_options.slow_call(m_options.slow_call_context, operation, ticks, n);
+}
+
+latency_histogram latency_monitor::histogram(latency_operation operation) const
+{
+    return operation == latency_operation::allocate
+         ? m_allocate.histogram()
+         : m_deallocate.histogram();
+}
+
+}  /// \namespace unbuggy
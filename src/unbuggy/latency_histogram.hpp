@@ -0,0 +1,223 @@
+/// \file latency_histogram.hpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#ifndef INCLUDED_UNBUGGY_LATENCY_HISTOGRAM
+#define INCLUDED_UNBUGGY_LATENCY_HISTOGRAM
+
+#include <atomic>       // atomic
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+
+#if !defined(__GNUC__) || !(defined(__x86_64__) || defined(__i386__))
+#include <chrono>       // steady_clock
+#endif
+
+namespace unbuggy {
+
+inline std::uint64_t cycle_count();
+    ///< Returns the current value of a cheap, monotonic tick counter.  On x86
+    /// processors, ticks are timestamp counter cycles; elsewhere, ticks are
+    /// nanoseconds of \c std::chrono::steady_clock.  Tick counts are meant to
+    /// be compared with one another, not converted to wall-clock time.
+
+/// A log-linear histogram of latencies, measured in ticks.  Values less than
+/// 8 each have their own bucket; larger values are grouped into 8 buckets per
+/// power of two, so that the width of each bucket is at most 1/8 of its lower
+/// bound.  Percentiles are accurate to within that width, and never exceed
+/// the largest recorded value.  A histogram is a plain value, and is not safe
+/// for concurrent modification; see \c latency_recorder.
+///
+class latency_histogram {
+
+  public:
+
+    static std::size_t const bucket_count = 496;
+        ///< number of buckets needed to cover all 64-bit values
+
+  private:
+
+    std::uint64_t m_buckets[bucket_count];  ///< count of values per bucket
+    std::uint64_t m_count;                  ///< total number of values
+    std::uint64_t m_max;                    ///< largest value recorded
+
+  public:
+
+    static std::size_t bucket_of(std::uint64_t ticks);
+        ///< Returns the index of the bucket counting \a ticks.
+
+    static std::uint64_t bucket_limit(std::size_t bucket);
+        ///< Returns the largest value counted by the specified \a bucket.
+
+    latency_histogram( );
+        ///< Creates an empty histogram.
+
+    void record(std::uint64_t ticks);
+        ///< Counts one value of \a ticks.
+
+    void add(std::size_t bucket, std::uint64_t count, std::uint64_t max);
+        ///< Counts \a count values in the specified \a bucket, the largest
+        /// of which is at most \a max.
+
+    void merge(latency_histogram const& other);
+        ///< Adds all values counted by \a other to this histogram.
+
+    std::uint64_t bucket(std::size_t i) const;
+        ///< Returns the number of values counted by bucket \a i.
+
+    std::uint64_t count() const;
+        ///< Returns the total number of values counted.
+
+    std::uint64_t max() const;
+        ///< Returns the largest value counted, or 0 if none.
+
+    std::uint64_t percentile(double fraction) const;
+        ///< Returns an upper bound on the smallest value not exceeded by the
+        /// specified \a fraction of counted values, or 0 if none.  The
+        /// behavior is undefined unless <code>0 <= fraction <= 1</code>.
+
+    std::uint64_t p50() const;
+        ///< Returns <code>percentile(0.5)</code>.
+
+    std::uint64_t p99() const;
+        ///< Returns <code>percentile(0.99)</code>.
+
+    std::uint64_t p999() const;
+        ///< Returns <code>percentile(0.999)</code>.
+};
+
+/// Records latencies from any number of threads into a fixed set of striped
+/// histograms.  Each thread is assigned a stripe on first use, so threads
+/// record without contending for cache lines unless there are more threads
+/// than stripes.  Counters are updated with relaxed atomic operations; a
+/// histogram read concurrently with recording may omit values still being
+/// recorded.
+///
+class latency_recorder {
+
+  public:
+
+    static std::size_t const stripe_count = 8;
+        ///< number of independent histograms
+
+  private:
+
+    struct stripe {
+        std::atomic<std::uint64_t> buckets[latency_histogram::bucket_count];
+        std::atomic<std::uint64_t> max;
+    };
+
+    stripe m_stripes[stripe_count];
+
+  public:
+
+    latency_recorder( );
+        ///< Creates a recorder having no recorded values.
+
+    latency_recorder( latency_recorder const& ) = delete;
+    latency_recorder& operator=( latency_recorder const& ) = delete;
+
+    void record(std::uint64_t ticks);
+        ///< Records \a ticks in the stripe of the calling thread.
+
+    latency_histogram histogram() const;
+        ///< Returns the sum of all stripes.
+};
+
+/// Identifies the timed operation passed to a slow-call hook.
+///
+enum class latency_operation {
+    allocate,
+    deallocate
+};
+
+/// Configures the timing of calls to an underlying allocator.
+///
+struct latency_options {
+
+    typedef void (*slow_call_hook)(
+            void*               context
+          , latency_operation   operation
+          , std::uint64_t       ticks
+          , std::size_t         n);
+        ///< the type of a function called with a user-supplied context, and
+        /// the operation, duration, and number of bytes of each timed call
+        /// slower than a threshold
+
+    std::size_t     sample_period;
+        ///< time one call in this many, rounded up to a power of 2; 0 or 1
+        /// times every call
+
+    std::uint64_t   slow_threshold;
+        ///< duration, in ticks, at or above which \c slow_call is invoked;
+        /// 0 invokes it for every timed call
+
+    slow_call_hook  slow_call;
+        ///< function called for each timed call reaching \c slow_threshold,
+        /// or null to call nothing
+
+    void*           slow_call_context;
+        ///< first argument passed to \c slow_call
+
+    latency_options( );
+        ///< Creates options timing every call, with no slow-call hook.
+};
+
+/// Times a sample of the calls made to an underlying allocator, recording
+/// allocation and deallocation latencies separately.  Calls are selected by
+/// their ordinal number, so that the decision to time a call costs one mask
+/// and test.  Recording is safe from multiple threads.
+///
+class latency_monitor {
+
+    latency_options     m_options;      ///< configuration
+    std::size_t         m_sample_mask;  ///< sample_period - 1
+    latency_recorder    m_allocate;     ///< allocation latencies
+    latency_recorder    m_deallocate;   ///< deallocation latencies
+
+  public:
+
+    explicit latency_monitor( latency_options const& options );
+        ///< Creates a monitor configured by \a options.
+
+    latency_options const& options() const;
+        ///< Returns the options of this monitor, with \c sample_period
+        /// rounded up to a power of 2.
+
+    bool samples(std::size_t call) const;
+        ///< Returns \c true if the call having the specified ordinal number
+        /// should be timed.
+
+    void record(
+            latency_operation   operation
+          , std::uint64_t       ticks
+          , std::size_t         n);
+        ///< Records a timed call to \a operation lasting \a ticks, for \a n
+        /// bytes.  Invokes the slow-call hook if \a ticks is at least
+        /// the threshold.
+
+    latency_histogram histogram(latency_operation operation) const;
+        ///< Returns the latencies recorded for \a operation.
+};
+
+// The following functions are called for each allocation while timing is
+// enabled, so are defined inline.
+
+inline std::uint64_t cycle_count()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline bool latency_monitor::samples(std::size_t call) const
+{
+    return (call & m_sample_mask) == 0;
+}
+
+}  /// \namespace unbuggy
+
+#endif
@@ -0,0 +1,164 @@
+/// @file latency_histogram_test.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+#include "unbuggy/latency_histogram.hpp"
+
+#include <cassert>      // assert
+#include <cstdint>      // uint64_t
+#include <vector>       // vector
+
+using unbuggy::latency_histogram;
+using unbuggy::latency_monitor;
+using unbuggy::latency_operation;
+using unbuggy::latency_options;
+using unbuggy::latency_recorder;
+
+void test_cycle_count()
+{
+    // The tick counter must not run backward.
+
+    std::uint64_t t0 = unbuggy::cycle_count();
+    std::uint64_t t1 = unbuggy::cycle_count();
+    assert(t0 <= t1);
+}
+
+void test_buckets()
+{
+    typedef latency_histogram H;
+
+    // Small values have their own buckets.
+
+    for (std::uint64_t v = 0; v < 8; ++v) {
+        assert(H::bucket_of(v) == v);
+        assert(H::bucket_limit(v) == v);
+    }
+
+    // Each larger value lies within its bucket, and bucket limits increase
+    // without gaps.
+
+    std::uint64_t const values[] = {
+        8, 9, 15, 16, 17, 100, 1000, 12345, 1u << 31, ~std::uint64_t(0)
+    };
+    for (std::uint64_t v: values) {
+        std::size_t b = H::bucket_of(v);
+        assert(b < H::bucket_count);
+        assert(v <= H::bucket_limit(b));
+        assert(v >  H::bucket_limit(b - 1));
+    }
+    assert(H::bucket_of(~std::uint64_t(0)) == H::bucket_count - 1);
+    assert(H::bucket_limit(H::bucket_count - 1) == ~std::uint64_t(0));
+
+    for (std::size_t b = 1; b < H::bucket_count; ++b) {
+        assert(H::bucket_of(H::bucket_limit(b - 1) + 1) == b);
+        assert(H::bucket_of(H::bucket_limit(b)) == b);
+    }
+
+    // Bucket width is at most 1/8 of the bucket's lower bound.
+
+    for (std::size_t b = 8; b < H::bucket_count; ++b) {
+        std::uint64_t lower = H::bucket_limit(b - 1) + 1;
+        assert(H::bucket_limit(b) - lower <= lower / 8);
+    }
+}
+
+void test_percentiles()
+{
+    latency_histogram h;
+    assert(h.count() == 0);
+    assert(h.max()   == 0);
+    assert(h.p50()   == 0);
+
+    for (std::uint64_t v = 1; v <= 1000; ++v)
+        h.record(v);
+
+    assert(h.count() == 1000);
+    assert(h.max()   == 1000);
+
+    // Percentiles are accurate to within a bucket, and never exceed the max.
+
+    assert(h.p50()  >= 500 && h.p50()  <= 500 + 500 / 8);
+    assert(h.p99()  >= 990 && h.p99()  <= 1000);
+    assert(h.p999() >= 999 && h.p999() <= 1000);
+    assert(h.percentile(1) == 1000);
+    assert(h.percentile(0) == 1);
+
+    // Merging adds counts and keeps the larger maximum.
+
+    latency_histogram g;
+    g.record(5000);
+    g.merge(h);
+    assert(g.count() == 1001);
+    assert(g.max()   == 5000);
+    assert(g.bucket(latency_histogram::bucket_of(5000)) == 1);
+}
+
+void test_recorder()
+{
+    latency_recorder r;
+    assert(r.histogram().count() == 0);
+
+    r.record(3);
+    r.record(3);
+    r.record(700);
+
+    latency_histogram h = r.histogram();
+    assert(h.count() == 3);
+    assert(h.max()   == 700);
+    assert(h.bucket(3) == 2);
+}
+
+void test_monitor()
+{
+    // Sample periods are rounded up to a power of 2.
+
+    latency_options o;
+    o.sample_period = 3;
+
+    latency_monitor m( o );
+    assert(m.options().sample_period == 4);
+    assert( m.samples(0));
+    assert(!m.samples(1));
+    assert(!m.samples(3));
+    assert( m.samples(4));
+
+    // The slow-call hook fires only at or above the threshold, and latencies
+    // of each operation are recorded separately.
+
+    std::vector<std::uint64_t> slow;
+    o.sample_period     = 1;
+    o.slow_threshold    = 100;
+    o.slow_call_context = &slow;
+    o.slow_call         = [](
+            void*             context
+          , latency_operation op
+          , std::uint64_t     t
+          , std::size_t       n)
+    {
+        assert(op == latency_operation::deallocate);
+        assert(n  == 16);
+        static_cast<std::vector<std::uint64_t>*>(context)->push_back(t);
+    };
+
+    latency_monitor s( o );
+    assert(s.samples(1));
+    s.record(latency_operation::allocate,    99, 8);
+    s.record(latency_operation::deallocate, 100, 16);
+    assert(slow.size() == 1 && slow[0] == 100);
+
+    assert(s.histogram(latency_operation::allocate).count()   == 1);
+    assert(s.histogram(latency_operation::allocate).max()     == 99);
+    assert(s.histogram(latency_operation::deallocate).count() == 1);
+    assert(s.histogram(latency_operation::deallocate).max()   == 100);
+}
+
+int main()
+{
+    test_cycle_count();
+    test_buckets();
+    test_percentiles();
+    test_recorder();
+    test_monitor();
+}
@@ -0,0 +1,47 @@
+/// @file pool_resource.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include "unbuggy/pool_resource.hpp"
+
+#include <cassert>  // assert
+
+namespace unbuggy {
+
+// m_pool is not yet constructed when its address is handed to the base, and
+// is destroyed before the base is.  Neither info_resource's constructor nor
+// its destructor touches the pool.
+
+pool_resource::pool_resource( std::pmr::memory_resource* upstream )
+  : info_resource( &m_pool )
+  , m_pool( upstream )
+{ }
+
+pool_resource::pool_resource(
+        std::pmr::pool_options const& options
+      , std::pmr::memory_resource*    upstream)
+  : info_resource( &m_pool )
+  , m_pool( options, upstream )
+{ }
+
+pool_resource::~pool_resource()
+{ }
+
+std::pmr::pool_options pool_resource::options() const
+{
+    return m_pool.options();
+}
+
+std::pmr::memory_resource* pool_resource::upstream_resource() const
+{
+    return m_pool.upstream_resource();
+}
+
+void pool_resource::release()
+{
+    assert(objects_now() == 0);
+
+    m_pool.release();
+}
+
+}  /// \namespace unbuggy
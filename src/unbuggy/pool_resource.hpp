@@ -0,0 +1,64 @@
+/// \file pool_resource.hpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#ifndef INCLUDED_UNBUGGY_POOL_RESOURCE
+#define INCLUDED_UNBUGGY_POOL_RESOURCE
+
+#include "unbuggy/info_resource.hpp"
+
+#include <memory_resource>  // pool_options, unsynchronized_pool_resource
+
+namespace unbuggy {
+
+/// A memory resource that serves blocks from pools of fixed-size chunks,
+/// counting them as an \c info_resource does.  Pools acquire capacity from
+/// an upstream resource ahead of need, and keep deallocated blocks for reuse
+/// until released or destroyed.  Statistics describe the requests made of
+/// the pools; to measure what the pools ask of their upstream resource,
+/// supply an \c info_resource as the upstream resource.
+///
+/// A \c pool_resource is built on \c std::pmr::unsynchronized_pool_resource
+/// and, like it, takes no locks: only one thread may allocate or deallocate
+/// at a time, though any thread may read the statistics.
+///
+class pool_resource: public info_resource {
+
+    std::pmr::unsynchronized_pool_resource m_pool;  ///< underlying pools
+
+  public:
+
+    explicit pool_resource(
+            std::pmr::memory_resource* upstream =
+                std::pmr::get_default_resource());
+        ///< Creates a pool resource having default options, acquiring memory
+        /// from \a upstream, which must outlive this object.
+
+    explicit pool_resource(
+            std::pmr::pool_options const& options
+          , std::pmr::memory_resource*    upstream =
+                std::pmr::get_default_resource());
+        ///< Creates a pool resource configured by \a options, acquiring
+        /// memory from \a upstream, which must outlive this object.
+
+    ~pool_resource();
+        ///< Destroys this object, returning all memory to the upstream
+        /// resource.
+
+    std::pmr::pool_options options() const;
+        ///< Returns the options in effect for this resource, which may differ
+        /// from those supplied at construction.
+
+    std::pmr::memory_resource* upstream_resource() const override;
+        ///< Returns the resource from which the pools acquire chunks, rather
+        /// than the pools themselves.
+
+    void release();
+        ///< Returns all memory retained by the pools to the upstream
+        /// resource.  The behavior is undefined unless every block allocated
+        /// from this resource has been deallocated.
+};
+
+}  /// \namespace unbuggy
+
+#endif
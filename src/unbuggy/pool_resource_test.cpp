@@ -0,0 +1,86 @@
+/// @file pool_resource_test.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+#include "unbuggy/pool_resource.hpp"
+
+#include <cassert>          // assert
+#include <cstddef>          // size_t
+#include <list>             // pmr::list
+
+using unbuggy::info_resource;
+using unbuggy::pool_resource;
+
+void test_pool()
+{
+    // Statistics describe requests made of the pool; an info_resource
+    // upstream measures the requests the pool makes in turn.
+
+    info_resource  upstream;
+    pool_resource  pool( &upstream );
+    assert(pool.upstream_resource() == &upstream);
+
+    info_resource& base = pool;         // does not expose the std pool
+    assert(base.upstream_resource() == &upstream);
+    assert(pool.options().largest_required_pool_block > 0);
+
+    {
+        std::pmr::list<int> l( &pool );
+        for (int i = 0; i < 100; ++i)
+            l.push_back(i);
+
+        assert(pool.allocate_calls() == 100);
+        assert(pool.objects_now()    == 100);
+        assert(upstream.allocate_calls() < pool.allocate_calls());
+        assert(upstream.memory_now() >= pool.memory_now());
+
+        // Deallocated blocks are retained by the pool for reuse.
+
+        std::size_t retained = upstream.memory_now();
+        l.clear();
+        assert(pool.objects_now()      == 0);
+        assert(pool.deallocate_calls() == 100);
+        assert(upstream.memory_now()   == retained);
+
+        l.resize(100);
+        assert(pool.allocate_calls() == 200);
+        assert(upstream.memory_now() == retained);
+    }
+
+    // Once all blocks are deallocated, release returns all retained memory
+    // upstream.
+
+    pool.deallocate(pool.allocate(16), 16);
+    assert(pool.objects_now()    == 0);
+    assert(upstream.memory_now() >  0);
+
+    pool.release();
+    assert(pool.objects_now()    == 0);
+    assert(upstream.memory_now() == 0);
+}
+
+void test_options()
+{
+    std::pmr::pool_options o;
+    o.max_blocks_per_chunk        = 4;
+    o.largest_required_pool_block = 64;
+
+    info_resource upstream;
+    pool_resource pool( o, &upstream );
+    assert(pool.options().max_blocks_per_chunk <= 4);
+
+    // Blocks larger than the largest pool block go directly upstream.
+
+    void* p = pool.allocate(4096);
+    assert(upstream.memory_now() >= 4096);
+    pool.deallocate(p, 4096);
+    assert(pool.memory_now() == 0);
+}
+
+int main()
+{
+    test_pool();
+    test_options();
+}
@@ -0,0 +1,5 @@
+/// @file trace_map.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#include "unbuggy/trace_map.hpp"
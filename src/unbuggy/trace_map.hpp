@@ -0,0 +1,190 @@
+/// \file trace_map.hpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+#ifndef INCLUDED_UNBUGGY_TRACE_MAP
+#define INCLUDED_UNBUGGY_TRACE_MAP
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <type_traits>  // integral_constant
+
+namespace unbuggy {
+
+/// Lists the byte offsets of the pointer fields of a collectible type.  Each
+/// offset names a field holding either a null pointer or the address of a
+/// collectible object.  Offsets are typically computed with \c offsetof, and
+/// must be suitably aligned for, and leave room for, a <code>void*</code>
+/// within the object.
+///
+/// \param Offsets byte offsets of pointer fields, in any order
+///
+template <std::size_t... Offsets>
+struct trace_offsets {
+    static std::size_t const values[sizeof...(Offsets) + 1];
+        ///< the offsets, followed by a single unused element so that the
+        /// array is never empty
+};
+
+/// Declares the pointer fields of a collectible type.  Collectible types that
+/// contain pointers to other collectible objects specialize this template,
+/// defining \c type as an instantiation of \c trace_offsets.  For example:
+///
+/// \code
+///     struct node {
+///         node* left;
+///         node* right;
+///         int   value;
+///     };
+///
+///     namespace unbuggy {
+///
+///     template <>
+///     struct trace_fields<node> {
+///         typedef trace_offsets<
+///             offsetof(node, left)
+///           , offsetof(node, right)
+///         > type;
+///     };
+///
+///     }
+/// \endcode
+///
+/// The primary template declares no fields, so that types for which it is
+/// not specialized are leaves: they are never scanned by the collector.
+///
+/// \param T the collectible type
+///
+template <typename T>
+struct trace_fields {
+    typedef trace_offsets<> type;   ///< no pointer fields
+};
+
+/// Describes the pointer fields of a collectible type without naming the
+/// type, so that a mark loop may scan objects of many types without virtual
+/// dispatch.  Descriptors are statically initialized by \c trace_map, and
+/// remain valid for the life of the program.
+///
+struct trace_descriptor {
+    std::size_t         size;       ///< object size, in bytes
+    std::size_t         count;      ///< number of pointer fields
+    std::size_t const*  offsets;    ///< \a count byte offsets of fields
+    std::uint64_t       bitmap;     ///< one bit per pointer-sized word, or 0
+};
+
+/// \cond DETAILS
+
+namespace trace_map_details {
+
+typedef std::integral_constant<bool, true>  use_bitmap;
+typedef std::integral_constant<bool, false> use_offsets;
+
+std::size_t const word_size = sizeof(void*);
+std::size_t const bitmap_words = 64;
+
+constexpr bool differs_from(std::size_t value);
+
+template <typename... Offsets>
+constexpr bool differs_from(
+        std::size_t value
+      , std::size_t first
+      , Offsets...  rest);
+
+constexpr bool valid_offsets(std::size_t size);
+
+template <typename... Offsets>
+constexpr bool valid_offsets(
+        std::size_t size
+      , std::size_t first
+      , Offsets...  rest);
+
+constexpr std::uint64_t bitmap_of();
+
+template <typename... Offsets>
+constexpr std::uint64_t bitmap_of(std::size_t first, Offsets... rest);
+
+inline unsigned lowest_bit(std::uint64_t bits);
+
+}  // namespace trace_map_details
+
+/// \endcond
+
+template <typename T, typename L = typename trace_fields<T>::type>
+class trace_map;
+
+/// Generates at compile time the layout of the pointer fields of type \c T,
+/// as declared by \c trace_fields<T>.  The generated map comprises a static
+/// table of field offsets and, for objects of at most 64 pointer-sized words,
+/// a bitmap having one bit set for each word holding a pointer field.  The
+/// map may be used directly, where the type of an object is known, or through
+/// its \c trace_descriptor, where it is not.
+///
+/// \param T the collectible type
+/// \param L the offsets of the pointer fields of \c T
+///
+template <typename T, std::size_t... Offsets>
+class trace_map<T, trace_offsets<Offsets...> > {
+
+    static_assert(
+            trace_map_details::valid_offsets(sizeof(T), Offsets...)
+          , "trace offsets must be distinct, and lie within T, aligned for "
+            "void*");
+
+    template <typename Visitor>
+    static void trace(
+            T&                              object
+          , Visitor&                        visit
+          , trace_map_details::use_bitmap);
+        ///< Passes \a visit the address of each pointer field of \a object,
+        /// locating the fields by bitmap.
+
+    template <typename Visitor>
+    static void trace(
+            T&                              object
+          , Visitor&                        visit
+          , trace_map_details::use_offsets);
+        ///< Passes \a visit the address of each pointer field of \a object,
+        /// locating the fields by offset table.
+
+  public:
+
+    static constexpr std::size_t count = sizeof...(Offsets);
+        ///< the number of pointer fields
+
+    static constexpr bool is_leaf = count == 0;
+        ///< \c true if objects of type \c T need never be scanned
+
+    static constexpr bool has_bitmap =
+        sizeof(T) <= trace_map_details::bitmap_words
+                   * trace_map_details::word_size;
+        ///< \c true if \c bitmap describes every pointer field
+
+    static constexpr std::uint64_t bitmap =
+        has_bitmap ? trace_map_details::bitmap_of(Offsets...) : 0;
+        ///< bit \c i is set if word \c i of an object holds a pointer field;
+        /// 0 unless \c has_bitmap
+
+    static std::size_t const* offsets();
+        ///< Returns the address of a static table of \c count field offsets.
+
+    static trace_descriptor const descriptor;
+        ///< type-erased description of this map
+
+    template <typename Visitor>
+    static void trace(T& object, Visitor&& visit);
+        ///< Calls <code>visit(void** slot)</code> with the address of each
+        /// pointer field of \a object.  Does nothing if \c is_leaf.
+};
+
+template <typename Visitor>
+void trace(trace_descriptor const& d, void* object, Visitor&& visit);
+    ///< Calls <code>visit(void** slot)</code> with the address of each pointer
+    /// field of \a object, which must be of the type described by \a d.  The
+    /// loop neither branches on nor dispatches by the type of \a object, and
+    /// does nothing if <code>d.count</code> is 0; callers may test \c count
+    /// to avoid queueing leaf objects for scanning at all.
+
+}  /// \namespace unbuggy
+
+#include "unbuggy/trace_map.tpp"
+#endif
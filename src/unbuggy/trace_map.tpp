@@ -0,0 +1,157 @@
+/// \file trace_map.tpp
+///
+/// \copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+
+namespace unbuggy {
+
+template <std::size_t... Offsets>
+std::size_t const
+trace_offsets<Offsets...>::values[sizeof...(Offsets) + 1] = { Offsets..., 0 };
+
+/// \cond DETAILS
+
+namespace trace_map_details {
+
+// Returns true.  Terminates the recursion of the variadic overload.
+//
+constexpr bool differs_from(std::size_t)
+{
+    return true;
+}
+
+// Returns true if the specified value differs from every other argument.
+//
+template <typename... Offsets>
+constexpr bool differs_from(
+        std::size_t value
+      , std::size_t first
+      , Offsets...  rest)
+{
+    return value != first && differs_from(value, rest...);
+}
+
+// Returns true.  Terminates the recursion of the variadic overload.
+//
+constexpr bool valid_offsets(std::size_t)
+{
+    return true;
+}
+
+// Returns true if each offset is aligned for, and leaves room for, a void*
+// within an object of the specified size, and no offset is repeated.
+//
+template <typename... Offsets>
+constexpr bool valid_offsets(
+        std::size_t size
+      , std::size_t first
+      , Offsets...  rest)
+{
+    return first % alignof(void*) == 0
+        && first + word_size <= size
+        && differs_from(first, rest...)
+        && valid_offsets(size, rest...);
+}
+
+// Returns 0.  Terminates the recursion of the variadic overload.
+//
+constexpr std::uint64_t bitmap_of()
+{
+    return 0;
+}
+
+// Returns a bitmap having one bit set for the word at each offset.  Words
+// beyond the width of the bitmap are ignored.
+//
+template <typename... Offsets>
+constexpr std::uint64_t bitmap_of(std::size_t first, Offsets... rest)
+{
+    return (first / word_size < bitmap_words
+                ? std::uint64_t(1) << first / word_size
+                : 0)
+         | bitmap_of(rest...);
+}
+
+// Returns the index of the lowest set bit of the specified nonzero value.
+//
+inline unsigned lowest_bit(std::uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    unsigned r = 0;
+    for (; !(bits & 1); bits >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+}  // namespace trace_map_details
+
+/// \endcond
+
+template <typename T, std::size_t... Offsets>
+constexpr std::size_t trace_map<T, trace_offsets<Offsets...> >::count;
+
+template <typename T, std::size_t... Offsets>
+constexpr bool trace_map<T, trace_offsets<Offsets...> >::is_leaf;
+
+template <typename T, std::size_t... Offsets>
+constexpr bool trace_map<T, trace_offsets<Offsets...> >::has_bitmap;
+
+template <typename T, std::size_t... Offsets>
+constexpr std::uint64_t trace_map<T, trace_offsets<Offsets...> >::bitmap;
+
+template <typename T, std::size_t... Offsets>
+trace_descriptor const trace_map<T, trace_offsets<Offsets...> >::descriptor = {
+    sizeof(T)
+  , sizeof...(Offsets)
+  , trace_offsets<Offsets...>::values
+  , trace_map<T, trace_offsets<Offsets...> >::bitmap
+};
+
+template <typename T, std::size_t... Offsets>
+std::size_t const* trace_map<T, trace_offsets<Offsets...> >::offsets()
+{
+    return trace_offsets<Offsets...>::values;
+}
+
+template <typename T, std::size_t... Offsets>
+template <typename Visitor>
+void trace_map<T, trace_offsets<Offsets...> >::trace(
+        T&                              object
+      , Visitor&                        visit
+      , trace_map_details::use_bitmap)
+{
+    void** words = reinterpret_cast<void**>(&object);
+    for (std::uint64_t bits = bitmap; bits; bits &= bits - 1)
+        visit(words + trace_map_details::lowest_bit(bits));
+}
+
+template <typename T, std::size_t... Offsets>
+template <typename Visitor>
+void trace_map<T, trace_offsets<Offsets...> >::trace(
+        T&                              object
+      , Visitor&                        visit
+      , trace_map_details::use_offsets)
+{
+    unbuggy::trace(descriptor, &object, visit);
+}
+
+template <typename T, std::size_t... Offsets>
+template <typename Visitor>
+void trace_map<T, trace_offsets<Offsets...> >::trace(
+        T&          object
+      , Visitor&&   visit)
+{
+    trace(object, visit, std::integral_constant<bool, has_bitmap>( ));
+}
+
+}  /// \namespace unbuggy
+
+template <typename Visitor>
+void unbuggy::trace(trace_descriptor const& d, void* object, Visitor&& visit)
+{
+    char* base = static_cast<char*>(object);
+    for (std::size_t const *o = d.offsets, *e = o + d.count; o != e; ++o)
+        visit(reinterpret_cast<void**>(base + *o));
+}
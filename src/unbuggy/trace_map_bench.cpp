@@ -0,0 +1,251 @@
+/// @file trace_map_bench.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+// Compares the marking throughput of a mark loop driven by trace_map
+// descriptors to that of a mark loop calling a virtual trace function per
+// object.  Both loops mark identical random graphs of objects having zero,
+// two, or four pointer fields, and report the number of objects marked per
+// second.
+
+#include "unbuggy/trace_map.hpp"
+
+#include <chrono>       // steady_clock
+#include <cstddef>      // offsetof, size_t
+#include <iostream>     // cout
+#include <random>       // mt19937
+#include <vector>       // vector
+
+namespace {
+
+std::size_t const object_count = 1 << 20;
+int         const repetitions  = 10;
+
+// Descriptor-traced objects begin with a header identifying their layout.
+
+struct header {
+    unbuggy::trace_descriptor const* type;
+    bool                             marked;
+};
+
+struct d_leaf { header h; long value; };
+struct d_pair { header h; header* a; header* b; };
+struct d_quad { header h; header* a; header* b; header* c; header* d; };
+
+}  // close unnamed namespace
+
+namespace unbuggy {
+
+template <>
+struct trace_fields<d_pair> {
+    typedef trace_offsets<offsetof(d_pair, a), offsetof(d_pair, b)> type;
+};
+
+template <>
+struct trace_fields<d_quad> {
+    typedef trace_offsets<
+        offsetof(d_quad, a)
+      , offsetof(d_quad, b)
+      , offsetof(d_quad, c)
+      , offsetof(d_quad, d)
+    > type;
+};
+
+}  // namespace unbuggy
+
+namespace {
+
+// Virtually-traced objects trace themselves.
+
+struct v_object;
+
+struct v_marker {
+    std::vector<v_object*> stack;
+    void visit(v_object* p);
+};
+
+struct v_object {
+    bool marked;
+    v_object( ): marked( false ) { }
+    virtual ~v_object() { }
+    virtual void trace(v_marker& m) = 0;
+};
+
+void v_marker::visit(v_object* p)
+{
+    if (p && !p->marked) {
+        p->marked = true;
+        stack.push_back(p);
+    }
+}
+
+struct v_leaf: v_object {
+    long value;
+    void trace(v_marker&) { }
+};
+
+struct v_pair: v_object {
+    v_object* a; v_object* b;
+    void trace(v_marker& m) { m.visit(a); m.visit(b); }
+};
+
+struct v_quad: v_object {
+    v_object* a; v_object* b; v_object* c; v_object* d;
+    void trace(v_marker& m) { m.visit(a); m.visit(b); m.visit(c); m.visit(d); }
+};
+
+// Returns the kinds (0 = leaf, 1 = pair, 2 = quad) and edges of a random
+// graph.  Only odd-numbered objects may be leaves.  Each non-leaf points
+// to its successor and, if that successor is a leaf, to the object after, so
+// that all objects are reachable from object 0; remaining edges are random.
+
+struct graph {
+    std::vector<int>         kind;
+    std::vector<std::size_t> edges;     // 4 per object
+};
+
+graph make_graph()
+{
+    graph g;
+    std::mt19937 rng( 42 );
+    std::uniform_int_distribution<int>         kinds( 0, 2 );
+    std::uniform_int_distribution<std::size_t> targets( 0, object_count - 1 );
+
+    g.kind.resize(object_count);
+    g.edges.resize(4 * object_count);
+    for (std::size_t i = 0; i < object_count; ++i) {
+        g.kind[i] = i % 2 ? kinds(rng) : 1 + kinds(rng) % 2;
+        for (int j = 0; j < 4; ++j)
+            g.edges[4 * i + j] = targets(rng);
+    }
+    for (std::size_t i = 0; i + 1 < object_count; ++i) {
+        g.edges[4 * i] = i + 1;
+        if (g.kind[i + 1] == 0 && i + 2 < object_count)
+            g.edges[4 * i + 1] = i + 2;
+    }
+
+    return g;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+double bench_descriptors(graph const& g)
+{
+    std::vector<header*> objects( object_count );
+    for (std::size_t i = 0; i < object_count; ++i) {
+        switch (g.kind[i]) {
+          case 0: objects[i] = &(new d_leaf)->h;
+                  objects[i]->type = &unbuggy::trace_map<d_leaf>::descriptor;
+                  break;
+          case 1: objects[i] = &(new d_pair)->h;
+                  objects[i]->type = &unbuggy::trace_map<d_pair>::descriptor;
+                  break;
+          case 2: objects[i] = &(new d_quad)->h;
+                  objects[i]->type = &unbuggy::trace_map<d_quad>::descriptor;
+                  break;
+        }
+    }
+    for (std::size_t i = 0; i < object_count; ++i) {
+        header* h = objects[i];
+        char* base = reinterpret_cast<char*>(h);
+        for (std::size_t j = 0; j < h->type->count; ++j)
+            *reinterpret_cast<header**>(base + h->type->offsets[j]) =
+                objects[g.edges[4 * i + j]];
+    }
+
+    std::vector<header*> stack;
+    std::size_t marked = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (header* h: objects)
+            h->marked = false;
+        auto visit = [&](void** slot) {
+            header* c = static_cast<header*>(*slot);
+            if (c && !c->marked) {
+                c->marked = true;
+                ++marked;
+                if (c->type->count)
+                    stack.push_back(c);
+            }
+        };
+        objects[0]->marked = true;
+        ++marked;
+        stack.push_back(objects[0]);
+        while (!stack.empty()) {
+            header* h = stack.back();
+            stack.pop_back();
+            unbuggy::trace(*h->type, h, visit);
+        }
+    }
+    double s = seconds_since(start);
+
+    for (header* h: objects) {
+        switch (h->type->count) {
+          case 0: delete reinterpret_cast<d_leaf*>(h); break;
+          case 2: delete reinterpret_cast<d_pair*>(h); break;
+          case 4: delete reinterpret_cast<d_quad*>(h); break;
+        }
+    }
+    return marked / s;
+}
+
+double bench_virtual(graph const& g)
+{
+    std::vector<v_object*> objects( object_count );
+    for (std::size_t i = 0; i < object_count; ++i) {
+        switch (g.kind[i]) {
+          case 0: objects[i] = new v_leaf; break;
+          case 1: objects[i] = new v_pair; break;
+          case 2: objects[i] = new v_quad; break;
+        }
+    }
+    for (std::size_t i = 0; i < object_count; ++i) {
+        std::size_t const* e = &g.edges[4 * i];
+        if (v_pair* p = dynamic_cast<v_pair*>(objects[i])) {
+            p->a = objects[e[0]]; p->b = objects[e[1]];
+        }
+        else if (v_quad* q = dynamic_cast<v_quad*>(objects[i])) {
+            q->a = objects[e[0]]; q->b = objects[e[1]];
+            q->c = objects[e[2]]; q->d = objects[e[3]];
+        }
+    }
+
+    v_marker m;
+    std::size_t marked = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (v_object* p: objects)
+            p->marked = false;
+        m.visit(objects[0]);
+        while (!m.stack.empty()) {
+            v_object* p = m.stack.back();
+            m.stack.pop_back();
+            ++marked;
+            p->trace(m);
+        }
+    }
+    double s = seconds_since(start);
+
+    for (v_object* p: objects)
+        delete p;
+    return marked / s;
+}
+
+}  // close unnamed namespace
+
+int main()
+{
+    graph g = make_graph();
+
+    double d = bench_descriptors(g);
+    double v = bench_virtual(g);
+
+    std::cout << "trace_map descriptors: " << d / 1e6 << " M objects/s\n"
+              << "virtual trace:         " << v / 1e6 << " M objects/s\n";
+}
@@ -0,0 +1,152 @@
+/// @file trace_map_test.cpp
+///
+/// @copyright Copyright 2013 Unbuggy Software LLC.  All rights reserved.
+///
+/// @cond
+
+#include "unbuggy/trace_map.hpp"
+
+#include <cassert>      // assert
+#include <cstddef>      // offsetof
+#include <vector>       // vector
+
+// A node is a collectible type having two pointer fields, separated by a
+// field that must not be traced.
+//
+struct node {
+    node* left;
+    long  value;
+    node* right;
+};
+
+namespace unbuggy {
+
+template <>
+struct trace_fields<node> {
+    typedef trace_offsets<offsetof(node, left), offsetof(node, right)> type;
+};
+
+}
+
+// A leaf is a collectible type having no pointer fields.  trace_fields is not
+// specialized for leaves.
+//
+struct leaf {
+    long value;
+};
+
+// A wide object is too large to be described by a bitmap, so must be traced
+// by offset table.
+//
+struct wide {
+    long  padding[100];
+    wide* next;
+};
+
+namespace unbuggy {
+
+template <>
+struct trace_fields<wide> {
+    typedef trace_offsets<offsetof(wide, next)> type;
+};
+
+}
+
+// A recorder collects the slots passed to it by trace.
+//
+struct recorder {
+    std::vector<void**>* slots;
+
+    void operator()(void** slot) const
+    {
+        slots->push_back(slot);
+    }
+};
+
+typedef unbuggy::trace_map<node> N;
+typedef unbuggy::trace_map<leaf> L;
+typedef unbuggy::trace_map<wide> W;
+
+void test_compile_time_layout()
+{
+    static_assert(N::count == 2,    "node has two pointer fields");
+    static_assert(!N::is_leaf,      "node must be scanned");
+    static_assert(N::has_bitmap,    "node fits in a bitmap");
+    static_assert(
+            N::bitmap == (1u << 0 | 1u << 2)
+          , "node pointers are words 0 and 2");
+
+    static_assert(L::count == 0,    "leaf has no pointer fields");
+    static_assert(L::is_leaf,       "leaf must never be scanned");
+    static_assert(L::bitmap == 0,   "leaf has an empty bitmap");
+
+    static_assert(W::count == 1,    "wide has one pointer field");
+    static_assert(!W::has_bitmap,   "wide does not fit in a bitmap");
+    static_assert(W::bitmap == 0,   "wide has no bitmap");
+
+    static_assert(
+            !unbuggy::trace_map_details::valid_offsets(
+                sizeof(node), offsetof(node, left), offsetof(node, left))
+          , "repeated offsets are rejected");
+
+    assert(N::offsets()[0] == offsetof(node, left));
+    assert(N::offsets()[1] == offsetof(node, right));
+    assert(W::offsets()[0] == offsetof(wide, next));
+}
+
+void test_descriptor()
+{
+    unbuggy::trace_descriptor const& d = N::descriptor;
+    assert(d.size    == sizeof(node));
+    assert(d.count   == 2);
+    assert(d.offsets == N::offsets());
+    assert(d.bitmap  == N::bitmap);
+
+    assert(L::descriptor.count == 0);
+    assert(L::descriptor.size  == sizeof(leaf));
+}
+
+void test_trace()
+{
+    node a = { nullptr, 1, nullptr };
+    std::vector<void**> slots;
+    recorder r = { &slots };
+
+    // Typed tracing visits each pointer field exactly once.
+
+    N::trace(a, r);
+    assert(slots.size() == 2);
+    assert(slots[0] == reinterpret_cast<void**>(&a.left));
+    assert(slots[1] == reinterpret_cast<void**>(&a.right));
+
+    // Type-erased tracing visits the same fields.
+
+    slots.clear();
+    unbuggy::trace(N::descriptor, &a, r);
+    assert(slots.size() == 2);
+    assert(slots[0] == reinterpret_cast<void**>(&a.left));
+    assert(slots[1] == reinterpret_cast<void**>(&a.right));
+
+    // Leaves are never visited.
+
+    leaf b = { 2 };
+    slots.clear();
+    L::trace(b, r);
+    unbuggy::trace(L::descriptor, &b, r);
+    assert(slots.empty());
+
+    // Objects too large for a bitmap are traced by offset table.
+
+    wide c;
+    c.next = nullptr;
+    W::trace(c, r);
+    assert(slots.size() == 1);
+    assert(slots[0] == reinterpret_cast<void**>(&c.next));
+}
+
+int main()
+{
+    test_compile_time_layout();
+    test_descriptor();
+    test_trace();
+}
@@ -13,3 +13,12 @@
 /// to this library and its documentation.
 
 #include "unbuggy/info_allocator.hpp"
+#include "unbuggy/info_window.hpp"
+#include "unbuggy/latency_histogram.hpp"
+#include "unbuggy/trace_map.hpp"
+
+#if __cplusplus >= 201703L
+#include "unbuggy/arena_resource.hpp"
+#include "unbuggy/info_resource.hpp"
+#include "unbuggy/pool_resource.hpp"
+#endif